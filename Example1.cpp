@@ -1,10 +1,21 @@
 #include <direct.h>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <random>
 #include "Application.h"
 #include "glad/glad.h"
 #include "GLFW/glfw3.h"
 #include "gtc/type_ptr.hpp"
 
+#if defined(__AVX__)
+#include <immintrin.h>
+#define BALL_SIMD_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BALL_SIMD_SSE
+#endif
+
 using namespace ST;
 
 const unsigned int SCR_WIDTH = 800;
@@ -61,7 +72,11 @@ public:
 
 	virtual void Tick(float deltaTime) = 0;
 
-	virtual void Render(float deltaTime) = 0;
+	// fixed-rate simulation step, driven by Application::RunFixedSteps
+	virtual void FixedTick(float) {}
+
+	// alpha blends the previous and the current simulation state
+	virtual void Render(float deltaTime, float alpha) = 0;
 
 	virtual void Destroy() = 0;
 };
@@ -210,6 +225,12 @@ public:
 	{
 		processInput(window);
 		glfwPollEvents();
+	}
+
+	void FixedTick(float deltaTime)
+	{
+		prevPosX = ball.posX;
+		prevPosY = ball.posY;
 
 		ball.velocityY += gravity * deltaTime;
 		ball.posX += ball.velocityX * deltaTime;
@@ -237,20 +258,21 @@ public:
 		}
 	}
 
-	void Render(float deltaTime)
+	void Render(float deltaTime, float alpha)
 	{
 		// render
 		// ------
-		// print ball position
-		std::cout << "Ball Position: " << ball.posX << ", " << ball.posY << std::endl;
-		glUniform2f(glGetUniformLocation(shaderProgram, "ballPos"), ball.posX, ball.posY);
-		glUniform1f(glGetUniformLocation(shaderProgram, "ballRadius"), ball.radius);
+		// blend the last two simulation states
+		float posX = prevPosX + (ball.posX - prevPosX) * alpha;
+		float posY = prevPosY + (ball.posY - prevPosY) * alpha;
 
-		glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+		glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT);
 
 		// draw our first triangle
 		glUseProgram(shaderProgram);
+		glUniform2f(glGetUniformLocation(shaderProgram, "ballPos"), posX, posY);
+		glUniform1f(glGetUniformLocation(shaderProgram, "ballRadius"), ball.radius);
 		glBindVertexArray(VAO);
 		// seeing as we only have a single VAO there's no need to bind it every time, but we'll do so to keep things a bit more organized
 		//glDrawArrays(GL_TRIANGLES, 0, 6);
@@ -280,8 +302,8 @@ protected:
 	unsigned int fragmentShader;
 
 	float gravity = 10.0f;
-	float timeStep = 1.0f / 60.0f;
 	Ball ball = {100.0f, 300.0f, 300.0f, 1000.0f, 150.0f};
+	float prevPosX = ball.posX, prevPosY = ball.posY;
 };
 }
 
@@ -305,9 +327,312 @@ public:
 	}
 };
 
+// structure of arrays, the simulation streams through one field at a time
+struct BallStore
+{
+	std::vector<float> posX, posY;
+	std::vector<float> velocityX, velocityY;
+	std::vector<float> radius;
+
+	size_t Size() const { return radius.size(); }
+
+	void Add(const Ball& ball)
+	{
+		posX.push_back(ball.pos.x);
+		posY.push_back(ball.pos.y);
+		velocityX.push_back(ball.velocity.x);
+		velocityY.push_back(ball.velocity.y);
+		radius.push_back(ball.radius);
+	}
+};
+
+// uniform grid rebuilt every step with a counting sort, cells are as wide as the median ball. Balls wider than a
+// cell stay out of the grid and are tested against the cells their bounds cover, so a few large balls among many
+// small ones do not blow the cells up
+class UniformGrid
+{
+public:
+	void Build(const BallStore& store, float width, float height)
+	{
+		size_t count = store.Size();
+		medianRadius.assign(store.radius.begin(), store.radius.end());
+		float cellRadius = 0.5f;
+		if (count > 0)
+		{
+			std::nth_element(medianRadius.begin(), medianRadius.begin() + count / 2, medianRadius.end());
+			cellRadius = std::max(medianRadius[count / 2], cellRadius);
+		}
+		// no more cells than balls, a sparse grid would spend the pair loop on empty cells
+		float areaPerBall = width * height / static_cast<float>(std::max<size_t>(count, 1));
+		cellSize = std::max(cellRadius * 2.0f, std::sqrt(areaPerBall));
+		columns = std::max(1, static_cast<int>(std::ceil(width / cellSize)));
+		rows = std::max(1, static_cast<int>(std::ceil(height / cellSize)));
+
+		ballCells.resize(count);
+		largeBalls.clear();
+		cellStart.assign(static_cast<size_t>(columns) * rows + 1, 0);
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (store.radius[i] * 2.0f > cellSize)
+			{
+				ballCells[i] = LARGE_BALL;
+				largeBalls.push_back(static_cast<uint32_t>(i));
+				continue;
+			}
+			ballCells[i] = CellOf(store.posX[i], store.posY[i]);
+			++cellStart[ballCells[i] + 1];
+		}
+		for (size_t c = 1; c < cellStart.size(); ++c)
+			cellStart[c] += cellStart[c - 1];
+		cellBalls.resize(cellStart.back());
+		cellCursor.assign(cellStart.begin(), cellStart.end() - 1);
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (ballCells[i] != LARGE_BALL)
+				cellBalls[cellCursor[ballCells[i]]++] = static_cast<uint32_t>(i);
+		}
+	}
+
+	// calls func(a, b) once for every pair sharing a cell or touching neighbouring cells
+	template <typename Func>
+	void ForEachCandidatePair(const BallStore& store, Func&& func) const
+	{
+		// half of the neighbourhood, the other half is visited from the neighbouring cells
+		static const int offsets[4][2] = {{1, 0}, {-1, 1}, {0, 1}, {1, 1}};
+		for (int y = 0; y < rows; ++y)
+		{
+			for (int x = 0; x < columns; ++x)
+			{
+				uint32_t cell = static_cast<uint32_t>(y * columns + x);
+				for (uint32_t a = cellStart[cell]; a < cellStart[cell + 1]; ++a)
+				{
+					for (uint32_t b = a + 1; b < cellStart[cell + 1]; ++b)
+						func(cellBalls[a], cellBalls[b]);
+					for (auto& offset : offsets)
+					{
+						int nx = x + offset[0], ny = y + offset[1];
+						if (nx < 0 || nx >= columns || ny >= rows)
+							continue;
+						uint32_t neighbour = static_cast<uint32_t>(ny * columns + nx);
+						for (uint32_t b = cellStart[neighbour]; b < cellStart[neighbour + 1]; ++b)
+							func(cellBalls[a], cellBalls[b]);
+					}
+				}
+			}
+		}
+
+		for (size_t i = 0; i < largeBalls.size(); ++i)
+		{
+			uint32_t large = largeBalls[i];
+			for (size_t j = i + 1; j < largeBalls.size(); ++j)
+				func(large, largeBalls[j]);
+
+			// a small ball touching this one has its center within the bounds grown by one cell
+			float radius = store.radius[large];
+			int minX, minY, maxX, maxY;
+			CellCoords(store.posX[large] - radius, store.posY[large] - radius, minX, minY);
+			CellCoords(store.posX[large] + radius, store.posY[large] + radius, maxX, maxY);
+			minX = std::max(minX - 1, 0);
+			minY = std::max(minY - 1, 0);
+			maxX = std::min(maxX + 1, columns - 1);
+			maxY = std::min(maxY + 1, rows - 1);
+			for (int y = minY; y <= maxY; ++y)
+			{
+				for (int x = minX; x <= maxX; ++x)
+				{
+					uint32_t cell = static_cast<uint32_t>(y * columns + x);
+					for (uint32_t b = cellStart[cell]; b < cellStart[cell + 1]; ++b)
+						func(large, cellBalls[b]);
+				}
+			}
+		}
+	}
+
+private:
+	static const uint32_t LARGE_BALL = ~0u;
+
+	void CellCoords(float x, float y, int& cx, int& cy) const
+	{
+		// balls that left the screen this step are clamped into the border cells
+		cx = std::min(std::max(static_cast<int>(x / cellSize), 0), columns - 1);
+		cy = std::min(std::max(static_cast<int>(y / cellSize), 0), rows - 1);
+	}
+
+	uint32_t CellOf(float x, float y) const
+	{
+		int cx, cy;
+		CellCoords(x, y, cx, cy);
+		return static_cast<uint32_t>(cy * columns + cx);
+	}
+
+	float cellSize = 1.0f;
+	int columns = 1, rows = 1;
+	std::vector<float> medianRadius;
+	std::vector<uint32_t> ballCells;
+	std::vector<uint32_t> largeBalls;
+	std::vector<uint32_t> cellStart;
+	std::vector<uint32_t> cellCursor;
+	std::vector<uint32_t> cellBalls;
+};
+
+// one lane per ball, the kernels below are written once against this interface
+struct ScalarLanes
+{
+	static const size_t WIDTH = 1;
+	typedef float Value;
+	typedef bool Mask;
+
+	static Value Load(const float* p) { return *p; }
+	static void Store(float* p, Value v) { *p = v; }
+	static Value Set(float s) { return s; }
+	static Value Add(Value a, Value b) { return a + b; }
+	static Value Sub(Value a, Value b) { return a - b; }
+	static Value Mul(Value a, Value b) { return a * b; }
+	static Value Negate(Value a) { return -a; }
+	static Mask Less(Value a, Value b) { return a < b; }
+	static Mask Greater(Value a, Value b) { return a > b; }
+	static Value Select(Mask mask, Value a, Value b) { return mask ? a : b; }
+};
+
+#if defined(BALL_SIMD_AVX)
+struct SimdLanes
+{
+	static const size_t WIDTH = 8;
+	typedef __m256 Value;
+	typedef __m256 Mask;
+
+	static Value Load(const float* p) { return _mm256_loadu_ps(p); }
+	static void Store(float* p, Value v) { _mm256_storeu_ps(p, v); }
+	static Value Set(float s) { return _mm256_set1_ps(s); }
+	static Value Add(Value a, Value b) { return _mm256_add_ps(a, b); }
+	static Value Sub(Value a, Value b) { return _mm256_sub_ps(a, b); }
+	static Value Mul(Value a, Value b) { return _mm256_mul_ps(a, b); }
+	static Value Negate(Value a) { return _mm256_xor_ps(a, _mm256_set1_ps(-0.0f)); }
+	static Mask Less(Value a, Value b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+	static Mask Greater(Value a, Value b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+	static Value Select(Mask mask, Value a, Value b) { return _mm256_blendv_ps(b, a, mask); }
+};
+#elif defined(BALL_SIMD_SSE)
+struct SimdLanes
+{
+	static const size_t WIDTH = 4;
+	typedef __m128 Value;
+	typedef __m128 Mask;
+
+	static Value Load(const float* p) { return _mm_loadu_ps(p); }
+	static void Store(float* p, Value v) { _mm_storeu_ps(p, v); }
+	static Value Set(float s) { return _mm_set1_ps(s); }
+	static Value Add(Value a, Value b) { return _mm_add_ps(a, b); }
+	static Value Sub(Value a, Value b) { return _mm_sub_ps(a, b); }
+	static Value Mul(Value a, Value b) { return _mm_mul_ps(a, b); }
+	static Value Negate(Value a) { return _mm_xor_ps(a, _mm_set1_ps(-0.0f)); }
+	static Mask Less(Value a, Value b) { return _mm_cmplt_ps(a, b); }
+	static Mask Greater(Value a, Value b) { return _mm_cmpgt_ps(a, b); }
+	static Value Select(Mask mask, Value a, Value b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+};
+#endif
+
+// returns the first ball it did not get to, the remainder is narrower than one register
+template <typename Lanes>
+size_t IntegrateLanes(BallStore& store, size_t begin, size_t end, float deltaTime, float gravity)
+{
+	typename Lanes::Value step = Lanes::Set(deltaTime);
+	typename Lanes::Value fall = Lanes::Set(gravity * deltaTime);
+	size_t i = begin;
+	for (; i + Lanes::WIDTH <= end; i += Lanes::WIDTH)
+	{
+		typename Lanes::Value velocityX = Lanes::Load(&store.velocityX[i]);
+		typename Lanes::Value velocityY = Lanes::Add(Lanes::Load(&store.velocityY[i]), fall);
+		Lanes::Store(&store.velocityY[i], velocityY);
+		Lanes::Store(&store.posX[i], Lanes::Add(Lanes::Load(&store.posX[i]), Lanes::Mul(velocityX, step)));
+		Lanes::Store(&store.posY[i], Lanes::Add(Lanes::Load(&store.posY[i]), Lanes::Mul(velocityY, step)));
+	}
+	return i;
+}
+
+template <typename Lanes>
+void ReflectLow(typename Lanes::Value& pos, typename Lanes::Value& velocity, typename Lanes::Value radius)
+{
+	typename Lanes::Mask hit = Lanes::Less(Lanes::Sub(pos, radius), Lanes::Set(0.0f));
+	pos = Lanes::Select(hit, radius, pos);
+	velocity = Lanes::Select(hit, Lanes::Negate(velocity), velocity);
+}
+
+template <typename Lanes>
+void ReflectHigh(typename Lanes::Value& pos, typename Lanes::Value& velocity, typename Lanes::Value radius,
+                 typename Lanes::Value extent)
+{
+	typename Lanes::Mask hit = Lanes::Greater(Lanes::Add(pos, radius), extent);
+	pos = Lanes::Select(hit, Lanes::Sub(extent, radius), pos);
+	velocity = Lanes::Select(hit, Lanes::Negate(velocity), velocity);
+}
+
+template <typename Lanes>
+size_t CollideWallsLanes(BallStore& store, size_t begin, size_t end, float width, float height)
+{
+	typename Lanes::Value right = Lanes::Set(width);
+	typename Lanes::Value bottom = Lanes::Set(height);
+	size_t i = begin;
+	for (; i + Lanes::WIDTH <= end; i += Lanes::WIDTH)
+	{
+		typename Lanes::Value radius = Lanes::Load(&store.radius[i]);
+		typename Lanes::Value posX = Lanes::Load(&store.posX[i]), velocityX = Lanes::Load(&store.velocityX[i]);
+		typename Lanes::Value posY = Lanes::Load(&store.posY[i]), velocityY = Lanes::Load(&store.velocityY[i]);
+		ReflectLow<Lanes>(posX, velocityX, radius);
+		ReflectHigh<Lanes>(posX, velocityX, radius, right);
+		ReflectHigh<Lanes>(posY, velocityY, radius, bottom);
+		ReflectLow<Lanes>(posY, velocityY, radius);
+		Lanes::Store(&store.posX[i], posX);
+		Lanes::Store(&store.velocityX[i], velocityX);
+		Lanes::Store(&store.posY[i], posY);
+		Lanes::Store(&store.velocityY[i], velocityY);
+	}
+	return i;
+}
+
+void IntegrateRange(BallStore& store, size_t begin, size_t end, float deltaTime, float gravity)
+{
+#if defined(BALL_SIMD_AVX) || defined(BALL_SIMD_SSE)
+	begin = IntegrateLanes<SimdLanes>(store, begin, end, deltaTime, gravity);
+#endif
+	IntegrateLanes<ScalarLanes>(store, begin, end, deltaTime, gravity);
+}
+
+void CollideWallsRange(BallStore& store, size_t begin, size_t end, float width, float height)
+{
+#if defined(BALL_SIMD_AVX) || defined(BALL_SIMD_SSE)
+	begin = CollideWallsLanes<SimdLanes>(store, begin, end, width, height);
+#endif
+	CollideWallsLanes<ScalarLanes>(store, begin, end, width, height);
+}
+
 class BilliardsExample : public Example
 {
 public:
+	// extraBallCount adds randomly placed small balls, seeded so every run is the same
+	explicit BilliardsExample(ST::JobSystem& jobSystem, size_t extraBallCount = 0) : jobSystem(jobSystem)
+	{
+		const Ball initialBalls[] = {
+			{30.0f, 300.0f, 300.0f, 1000.0f, 150.0f},
+			{30.0f, 25.0f, 400.0f, 300.0f, 400.0f},
+			{30.0f, 500.0f, 500.0f, 200.0f, 100.0f},
+			{30.0f, 100.0f, 100.0f, 300.0f, 200.0f},
+			{30.0f, 200.0f, 200.0f, 400.0f, 300.0f},
+			{30.0f, 400.0f, 400.0f, 500.0f, 400.0f},
+			{30.0f, 600.0f, 600.0f, 600.0f, 500.0f},
+		};
+		for (const Ball& ball : initialBalls)
+			balls.Add(ball);
+
+		std::mt19937 random(1234);
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+		for (size_t i = 0; i < extraBallCount; ++i)
+		{
+			balls.Add({2.0f, unit(random) * SCR_WIDTH, unit(random) * SCR_HEIGHT,
+				(unit(random) - 0.5f) * 400.0f, (unit(random) - 0.5f) * 400.0f});
+		}
+	}
+
 	void Init()
 	{
 // glfw: initialize and configure
@@ -442,23 +767,32 @@ public:
 		glfwPollEvents();
 	}
 
-	void Render(float deltaTime)
+	void FixedTick(float deltaTime)
+	{
+		prevPosX = balls.posX;
+		prevPosY = balls.posY;
+		Simulate(deltaTime);
+	}
+
+	void Render(float deltaTime, float alpha)
 	{
 		// render
 		// ------
-		// print ball position
-		glUniform2f(glGetUniformLocation(shaderProgram, "ballPos"), ball.posX, ball.posY);
-		glUniform1f(glGetUniformLocation(shaderProgram, "ballRadius"), ball.radius);
-
-		glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+		glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT);
 
-		// draw our first triangle
+		// one full screen quad per ball, the shader discards everything outside the circle
 		glUseProgram(shaderProgram);
 		glBindVertexArray(VAO);
-		// seeing as we only have a single VAO there's no need to bind it every time, but we'll do so to keep things a bit more organized
-		//glDrawArrays(GL_TRIANGLES, 0, 6);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+		bool hasPrevious = prevPosX.size() == balls.Size();
+		for (size_t i = 0; i < balls.Size(); ++i)
+		{
+			float posX = hasPrevious ? prevPosX[i] + (balls.posX[i] - prevPosX[i]) * alpha : balls.posX[i];
+			float posY = hasPrevious ? prevPosY[i] + (balls.posY[i] - prevPosY[i]) * alpha : balls.posY[i];
+			glUniform2f(glGetUniformLocation(shaderProgram, "ballPos"), posX, posY);
+			glUniform1f(glGetUniformLocation(shaderProgram, "ballRadius"), balls.radius[i]);
+			glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+		}
 		// glBindVertexArray(0); // no need to unbind it every time 
 
 		// glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
@@ -477,62 +811,68 @@ public:
 	}
 
 protected:
-	void SimulateBall(Ball& ball, float deltaTime)
+	// chunks have a fixed size, so each ball goes through the same lanes however many workers there are
+	template <typename Func>
+	void ForEachChunk(Func func)
 	{
-		ball.velocity.y += gravity * deltaTime;
-		ball.pos.x += ball.velocity.x * deltaTime;
-		ball.pos.y += ball.velocity.y * deltaTime;
+		size_t count = balls.Size();
+		size_t chunkSize = BALLS_PER_CHUNK;
+		size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+		jobSystem.ParallelFor(static_cast<uint32_t>(chunkCount), 1, [&](uint32_t chunk, uint32_t)
+		{
+			size_t begin = chunk * chunkSize;
+			func(begin, std::min(begin + chunkSize, count));
+		});
 	}
 
-	void Simulate(float deltaTime)
+	void Integrate(float deltaTime)
 	{
-		// for each balls simulate
-		for (int i = 0; i < balls.size(); ++i)
-		{
-			auto& ball = balls[i];
-			SimulateBall(ball, deltaTime);
+		ForEachChunk([&](size_t begin, size_t end) { IntegrateRange(balls, begin, end, deltaTime, gravity); });
+	}
 
-			// handle ball collision
-			for (int j = i + 1; j < balls.size(); ++j)
-			{
-				if (glm::distance(ball.pos, balls[j].pos) < ball.radius + balls[j].radius)
-				{
-					glm::vec2 normal = glm::normalize(balls[j].pos - ball.pos);
-					glm::vec2 relativeVelocity = balls[j].velocity - ball.velocity;
-					float dotProduct = glm::dot(relativeVelocity, normal);
-					if (dotProduct < 0)
-					{
-						float impulse = (-(1.0f + 1.0f) * dotProduct) / (1.0f / 1.0f + 1.0f / 1.0f);
-						ball.velocity -= impulse * normal / 1.0f;
-						balls[j].velocity += impulse * normal / 1.0f;
-					}
-				}
-			}
+	// equal masses, perfectly elastic
+	void ResolveCollision(uint32_t a, uint32_t b)
+	{
+		float dx = balls.posX[b] - balls.posX[a];
+		float dy = balls.posY[b] - balls.posY[a];
+		float radiusSum = balls.radius[a] + balls.radius[b];
+		float distanceSquared = dx * dx + dy * dy;
+		if (distanceSquared >= radiusSum * radiusSum || distanceSquared == 0.0f)
+			return;
 
-			// handle wall collision
-			if (ball.pos.x - ball.radius < 0.0f)
-			{
-				ball.pos.x = ball.radius;
-				ball.velocity.x = -ball.velocity.x;
-			}
-			if (ball.pos.x + ball.radius > SCR_WIDTH)
-			{
-				ball.pos.x = SCR_WIDTH - ball.radius;
-				ball.velocity.x = -ball.velocity.x;
-			}
-			if (ball.pos.y + ball.radius > SCR_HEIGHT)
-			{
-				ball.pos.y = SCR_HEIGHT - ball.radius;
-				ball.velocity.y = -ball.velocity.y;
-			}
-			if (ball.pos.y - ball.radius < 0.0f)
-			{
-				ball.pos.y = ball.radius;
-				ball.velocity.y = -ball.velocity.y;
-			}
+		float inverseDistance = 1.0f / std::sqrt(distanceSquared);
+		float normalX = dx * inverseDistance, normalY = dy * inverseDistance;
+		float dotProduct = (balls.velocityX[b] - balls.velocityX[a]) * normalX +
+			(balls.velocityY[b] - balls.velocityY[a]) * normalY;
+		if (dotProduct < 0)
+		{
+			float impulse = (-(1.0f + 1.0f) * dotProduct) / (1.0f / 1.0f + 1.0f / 1.0f);
+			balls.velocityX[a] -= impulse * normalX;
+			balls.velocityY[a] -= impulse * normalY;
+			balls.velocityX[b] += impulse * normalX;
+			balls.velocityY[b] += impulse * normalY;
 		}
 	}
 
+	void CollideWalls()
+	{
+		ForEachChunk([&](size_t begin, size_t end)
+		{
+			CollideWallsRange(balls, begin, end, static_cast<float>(SCR_WIDTH), static_cast<float>(SCR_HEIGHT));
+		});
+	}
+
+	void Simulate(float deltaTime)
+	{
+		Integrate(deltaTime);
+
+		// broadphase narrows the pairs down to neighbouring grid cells
+		grid.Build(balls, static_cast<float>(SCR_WIDTH), static_cast<float>(SCR_HEIGHT));
+		grid.ForEachCandidatePair(balls, [this](uint32_t a, uint32_t b) { ResolveCollision(a, b); });
+
+		CollideWalls();
+	}
+
 protected:
 	GLFWwindow* window;
 	unsigned int VBO, VAO, EBO;
@@ -541,15 +881,13 @@ protected:
 	unsigned int fragmentShader;
 
 	float gravity = 10.0f;
-	std::vector<Ball> balls = {
-		{30.0f, 300.0f, 300.0f, 1000.0f, 150.0f},
-		{30.0f, 25.0f, 400.0f, 300.0f, 400.0f},
-		{30.0f, 500.0f, 500.0f, 200.0f, 100.0f},
-		{30.0f, 100.0f, 100.0f, 300.0f, 200.0f},
-		{30.0f, 200.0f, 200.0f, 400.0f, 300.0f},
-		{30.0f, 400.0f, 400.0f, 500.0f, 400.0f},
-		{30.0f, 600.0f, 600.0f, 600.0f, 500.0f},
-	};
+	BallStore balls;
+	UniformGrid grid;
+	std::vector<float> prevPosX, prevPosY;
+
+	// a multiple of every lane width
+	static const size_t BALLS_PER_CHUNK = 4096;
+	ST::JobSystem& jobSystem;
 };
 }
 
@@ -564,7 +902,9 @@ public:
 
 	virtual void Tick(float deltaTime) override { example->Tick(deltaTime); }
 
-	virtual void Render(float deltaTime) override { example->Render(deltaTime); }
+	virtual void FixedTick(float fixedDeltaTime) override { example->FixedTick(fixedDeltaTime); }
+
+	virtual void Render(float deltaTime) override { example->Render(deltaTime, GetFixedStepAlpha()); }
 
 	virtual void Destroy() override { example->Destroy(); }
 
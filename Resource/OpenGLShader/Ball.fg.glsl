@@ -9,15 +9,14 @@ uniform float ballRadius;
 
 void DrawCircle(float x, float y, float r)
 {
-   if(pow(FragPos.x-x,2)+pow(FragPos.y-y,2)<r*r)
+   if(pow(FragPos.x-x,2)+pow(FragPos.y-y,2)>=r*r)
    {
-       FragColor = vec4(0.0,0.0,0.0,1.0);
+       discard;
    }
+   FragColor = vec4(0.0,0.0,0.0,1.0);
 }
 
 void main()
 {
-    FragColor = vec4(1.0,1.0,1.0,1.0);
-    
     DrawCircle(ballPos.x,ballPos.y,ballRadius);
 }
\ No newline at end of file
@@ -28,9 +28,15 @@ in vec2 f_TexCoord;
 in vec3 f_FragPos;
 in vec3 f_Normal;
 
-uniform vec3 f_EyePos;
-uniform DirLight f_DirLight;
-uniform PointLight f_PointLight;
+layout (std140) uniform CameraBlock{
+    mat4 v_ViewProj;
+    mat4 v_SkyBoxViewProj;
+    vec3 f_EyePos;
+};
+layout (std140) uniform LightBlock{
+    DirLight f_DirLight;
+    PointLight f_PointLight;
+};
 uniform Material f_Material;
 
 out vec4 o_Color;
@@ -3,16 +3,20 @@ layout (location=0) in vec3 v_Pos;
 layout (location=1) in vec3 v_Normal;
 layout (location=2) in vec2 v_TexCoord;
 
-uniform mat4 v_Model;
-uniform mat4 v_ViewProj;
+layout (location=3) in mat4 v_InstanceModel;
+layout (std140) uniform CameraBlock{
+    mat4 v_ViewProj;
+    mat4 v_SkyBoxViewProj;
+    vec3 f_EyePos;
+};
 
 out vec2 f_TexCoord;
 out vec3 f_FragPos;
 out vec3 f_Normal;
 
 void main(){
-    gl_Position=v_ViewProj*v_Model*vec4(v_Pos,1.0f);
-    f_FragPos=vec3(v_Model*vec4(v_Pos,1.0f));
+    gl_Position=v_ViewProj*v_InstanceModel*vec4(v_Pos,1.0f);
+    f_FragPos=vec3(v_InstanceModel*vec4(v_Pos,1.0f));
     f_TexCoord=v_TexCoord;
-    f_Normal=vec3(transpose(inverse(v_Model))*vec4(v_Pos,1.0f));
+    f_Normal=vec3(transpose(inverse(v_InstanceModel))*vec4(v_Pos,1.0f));
 }
\ No newline at end of file
@@ -1,7 +1,11 @@
 #version 330 core
 layout (location=0) in vec3 v_Pos;
 uniform mat4 v_Model;
-uniform mat4 v_ViewProj;
+layout (std140) uniform CameraBlock{
+    mat4 v_ViewProj;
+    mat4 v_SkyBoxViewProj;
+    vec3 f_EyePos;
+};
 void main(){
     gl_Position=v_ViewProj*v_Model*vec4(v_Pos,1.0f);//
 }
\ No newline at end of file
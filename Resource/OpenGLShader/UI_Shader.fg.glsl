@@ -1,11 +1,35 @@
 ﻿#version 330 core
-uniform sampler2D f_Texture; 
-uniform vec4 f_Color;
+uniform sampler2D f_Textures[16];
 
 
 in vec2 f_TexCoord;
+in vec4 f_Color;
+flat in int f_TexIndex;
 out vec4 o_Color;
 
+// GLSL 330 only allows constant indices into sampler arrays
+vec4 SampleTexture(int index,vec2 texCoord){
+    switch(index){
+        case 0: return texture(f_Textures[0],texCoord);
+        case 1: return texture(f_Textures[1],texCoord);
+        case 2: return texture(f_Textures[2],texCoord);
+        case 3: return texture(f_Textures[3],texCoord);
+        case 4: return texture(f_Textures[4],texCoord);
+        case 5: return texture(f_Textures[5],texCoord);
+        case 6: return texture(f_Textures[6],texCoord);
+        case 7: return texture(f_Textures[7],texCoord);
+        case 8: return texture(f_Textures[8],texCoord);
+        case 9: return texture(f_Textures[9],texCoord);
+        case 10: return texture(f_Textures[10],texCoord);
+        case 11: return texture(f_Textures[11],texCoord);
+        case 12: return texture(f_Textures[12],texCoord);
+        case 13: return texture(f_Textures[13],texCoord);
+        case 14: return texture(f_Textures[14],texCoord);
+        case 15: return texture(f_Textures[15],texCoord);
+    }
+    return vec4(1.0f);
+}
+
 void main(){
-    o_Color=texture(f_Texture,f_TexCoord)*f_Color;// vec4(result,1.0f);
+    o_Color=SampleTexture(f_TexIndex,f_TexCoord)*f_Color;// vec4(result,1.0f);
 }
\ No newline at end of file
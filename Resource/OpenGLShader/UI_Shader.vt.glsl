@@ -1,11 +1,16 @@
 ﻿#version 330 core
 layout (location=0) in vec2 v_Pos;
 layout (location=1) in vec2 v_TexCoord;
-uniform mat4 v_TransformMat;
+layout (location=2) in vec4 v_Color;
+layout (location=3) in float v_TexIndex;
 out vec2 f_TexCoord;
+out vec4 f_Color;
+flat out int f_TexIndex;
 
 
 void main(){
-    gl_Position=v_TransformMat*vec4(v_Pos,0.0f,1.0f);
+    gl_Position=vec4(v_Pos,0.0f,1.0f);
     f_TexCoord=v_TexCoord;
+    f_Color=v_Color;
+    f_TexIndex=int(v_TexIndex);
 }
\ No newline at end of file
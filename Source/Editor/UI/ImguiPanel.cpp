@@ -1,12 +1,17 @@
 #include "ImguiPanel.h"
 
+#include <cmath>
+
 #include "imgui.h"
 #include "backends/imgui_impl_glfw.h"
 #include "backends/imgui_impl_opengl3.h"
 
+#include "PathManager.h"
+#include "Profiler.h"
+#include "Render/FramePacket.h"
 #include "Render/Light.h"
 
-void ST::ImguiPanel::Init(GLFWwindow* window) {
+void ST::ImguiPanel::Init(GLFWwindow* window, bool bEnableViewports) {
 	const char* glsl_version = "#version 130";
 	// Setup Dear ImGui context
 	IMGUI_CHECKVERSION();
@@ -16,7 +21,8 @@ void ST::ImguiPanel::Init(GLFWwindow* window) {
 	io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard; // Enable Keyboard Controls
 	//io.ConfigFlags |= ImGuiConfigFlags_NavEnableGamepad;      // Enable Gamepad Controls
 	io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;   // Enable Docking
-	io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable; // Enable Multi-Viewport / Platform Windows
+	if (bEnableViewports)
+		io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable; // Enable Multi-Viewport / Platform Windows
 	//io.ConfigViewportsNoAutoMerge = true;
 	//io.ConfigViewportsNoTaskBarIcon = true;
 
@@ -34,6 +40,8 @@ void ST::ImguiPanel::Init(GLFWwindow* window) {
 	// Setup Platform/Renderer backends
 	ImGui_ImplGlfw_InitForOpenGL(window, true);
 	ImGui_ImplOpenGL3_Init(glsl_version);
+	/* builds the font atlas while the context is still current here, NewFrame would otherwise do it lazily */
+	ImGui_ImplOpenGL3_CreateDeviceObjects();
 	// Load Fonts
 	// - If no fonts are loaded, dear imgui will use the default font. You can also load multiple fonts and use ImGui::PushFont()/PopFont() to select them.
 	// - AddFontFromFileTTF() will return the ImFont* so you can store it if you need to select the font among multiple.
@@ -72,6 +80,16 @@ void ST::ImguiPanel::Render() {
 	}
 }
 
+void ST::ImguiPanel::EndFrame(ImguiDrawSnapshot& snapshot) {
+	ImGui::Render();
+	snapshot.Capture(ImGui::GetDrawData());
+}
+
+void ST::ImguiPanel::RenderSnapshot(const ImguiDrawSnapshot& snapshot) {
+	if (!snapshot.IsEmpty())
+		ImGui_ImplOpenGL3_RenderDrawData(snapshot.GetDrawData());
+}
+
 void ST::ImguiPanel::NewFrame() {
 	// Start the Dear ImGui frame
 	ImGui_ImplOpenGL3_NewFrame();
@@ -103,3 +121,83 @@ void ST::ImguiPanel::CreateDirLightPanel(const char* name, ST_REF<DirLight> ligh
 void ST::ImguiPanel::ShowDemoPanel() {
 	ImGui::ShowDemoWindow();
 }
+
+void ST::ImguiPanel::CreateProfilerPanel(const char* name) {
+	static const float FRAME_BUDGET_MS = 1000.f / 60.f;
+	static const float ROW_HEIGHT      = 18.f;
+
+	Profiler& profiler = Profiler::GetProfiler();
+	auto& history      = profiler.GetHistory();
+	ImGui::Begin(name, 0, ImGuiConfigFlags_DockingEnable | ImGuiConfigFlags_ViewportsEnable);
+	bool paused = profiler.IsPaused();
+	if (ImGui::Checkbox("Pause", &paused))
+		profiler.SetPaused(paused);
+	ImGui::SameLine();
+	if (ImGui::Button("Save Chrome Trace")) {
+		ST_STRING tracePath = PathManager::GetProjectDir() + "ProfilerTrace.json";
+		if (profiler.SaveChromeTrace(tracePath))
+			ST_LOG("Profiler trace saved to %s\n", tracePath.c_str());
+	}
+	if (history.empty()) {
+		ImGui::End();
+		return;
+	}
+
+	float frameTimes[Profiler::HISTORY_FRAMES];
+	int frameCount = 0;
+	for (auto& frame : history) {
+		frameTimes[frameCount++] = (frame._endNs - frame._beginNs) / 1e6f;
+	}
+	const FrameRecord& lastFrame = history.back();
+	ImGui::Text("CPU frame %.2f ms", frameTimes[frameCount - 1]);
+	ImGui::PlotLines("##FrameTimes", frameTimes, frameCount, 0, nullptr, 0.f, FRAME_BUDGET_MS * 2,
+		ImVec2(-1, 60));
+
+	/* GPU results arrive a few frames late, show the newest resolved frame */
+	for (auto it = history.rbegin(); it != history.rend(); ++it) {
+		if (!it->_gpuResolved)
+			continue;
+		float gpuTotal = 0;
+		for (auto& pass : it->_gpuPasses) {
+			float passMs = pass._elapsedNs / 1e6f;
+			gpuTotal += passMs;
+			ImGui::ProgressBar(passMs / FRAME_BUDGET_MS, ImVec2(160, 0), "");
+			ImGui::SameLine();
+			ImGui::Text("%-12s %.3f ms", pass._name, passMs);
+		}
+		ImGui::Text("GPU total %.2f ms (frame %llu)", gpuTotal, static_cast<unsigned long long>(it->_frameIndex));
+		break;
+	}
+
+	/* one row per scope depth, threads stacked below each other */
+	ImGui::Separator();
+	uint32_t maxThread = 0, maxDepth = 0;
+	for (auto& event : lastFrame._cpuEvents) {
+		maxThread = event._threadId > maxThread ? event._threadId : maxThread;
+		maxDepth  = event._depth > maxDepth ? event._depth : maxDepth;
+	}
+	ImVec2 origin    = ImGui::GetCursorScreenPos();
+	float width      = ImGui::GetContentRegionAvail().x;
+	float rowsHeight = (maxThread + 1) * (maxDepth + 1) * ROW_HEIGHT;
+	double frameNs   = static_cast<double>(lastFrame._endNs - lastFrame._beginNs);
+	ImDrawList* drawList = ImGui::GetWindowDrawList();
+	ImVec2 mouse         = ImGui::GetIO().MousePos;
+	for (auto& event : lastFrame._cpuEvents) {
+		if (frameNs <= 0 || event._endNs < lastFrame._beginNs)
+			continue;
+		float x0 = origin.x + static_cast<float>((event._beginNs - lastFrame._beginNs) / frameNs) * width;
+		float x1 = origin.x + static_cast<float>((event._endNs - lastFrame._beginNs) / frameNs) * width;
+		float y0 = origin.y + (event._threadId * (maxDepth + 1) + event._depth) * ROW_HEIGHT;
+		ImU32 color = ImColor::HSV(fmodf(event._depth * 0.13f + event._threadId * 0.37f, 1.f), 0.5f, 0.8f);
+		drawList->AddRectFilled(ImVec2(x0, y0), ImVec2(x1 > x0 + 1 ? x1 : x0 + 1, y0 + ROW_HEIGHT - 1), color);
+		if (x1 - x0 > 40) {
+			drawList->PushClipRect(ImVec2(x0, y0), ImVec2(x1, y0 + ROW_HEIGHT), true);
+			drawList->AddText(ImVec2(x0 + 2, y0 + 2), IM_COL32_BLACK, event._name);
+			drawList->PopClipRect();
+		}
+		if (mouse.x >= x0 && mouse.x <= x1 && mouse.y >= y0 && mouse.y < y0 + ROW_HEIGHT)
+			ImGui::SetTooltip("%s %.3f ms", event._name, (event._endNs - event._beginNs) / 1e6f);
+	}
+	ImGui::Dummy(ImVec2(width, rowsHeight));
+	ImGui::End();
+}
@@ -5,17 +5,25 @@ namespace  ST
 {
     class DirLight;
     class PointLight;
+    class ImguiDrawSnapshot;
 
     class ImguiPanel
     {
     public:
-        static void Init(GLFWwindow* window);
+        /* Platform windows need the GL context on the main thread, a separate render thread turns them off */
+        static void Init(GLFWwindow* window,bool bEnableViewports = true);
         static void Close();
         static void Render();
         static void NewFrame();
+        /* Game thread half of Render, the draw data is copied out so the next frame can start right away */
+        static void EndFrame(ImguiDrawSnapshot& snapshot);
+        /* Render thread half of Render */
+        static void RenderSnapshot(const ImguiDrawSnapshot& snapshot);
         static void CreatePointLightPanel(const char* name,ST_REF<PointLight> light);
         static void CreateDirLightPanel(const char* name,ST_REF<DirLight> light);
         static void ShowDemoPanel();
+        /* Frame times, GPU pass timings and a CPU scope timeline of the last frame, from Profiler */
+        static void CreateProfilerPanel(const char* name);
     };
 }
 
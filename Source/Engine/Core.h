@@ -2,6 +2,7 @@
 
 #include <functional>
 #include <map>
+#include <unordered_map>
 
 #include "pch.h"
 #include "Log.h"
@@ -26,6 +27,10 @@ using ST_VECTOR = std::vector<Ty, Alloc>;
 template <class Kty, class Ty, class Pr = std::less<Kty>, class Alloc = std::allocator<std::pair<const Kty, Ty>>>
 using ST_MAP = std::map<Kty, Ty, Pr, Alloc>;
 
+template <class Kty, class Ty, class Hasher = std::hash<Kty>, class Keyeq = std::equal_to<Kty>,
+	class Alloc = std::allocator<std::pair<const Kty, Ty>>>
+using ST_UNORDERED_MAP = std::unordered_map<Kty, Ty, Hasher, Keyeq, Alloc>;
+
 template <class Fty>
 using ST_FUNC = std::function<Fty>;
 
@@ -8,12 +8,13 @@
 #include "Application.h"
 #include "CameraController.h"
 #include "Camera.h"
-#include "GameObject.h"
 
 #include "Log.h"
 #include "MeshBuilder.h"
 #include "PathManager.h"
+#include "Profiler.h"
 #include "ResourceManager.h"
+#include "ECS/SceneComponents.h"
 #include "Event/EventCode.h"
 #include "Math/Transform.h"
 #include "Render/Light.h"
@@ -27,15 +28,32 @@
 
 // #include "glad/glad.h"
 
-ST::AppWindow::AppWindow(int width, int height, bool bFullScreen): _width(width), _height(height),
-	_bFullScreen(bFullScreen), _userData(nullptr) {}
+ST::AppWindow::AppWindow(int width, int height, bool bFullScreen, bool bHeadless): _width(width),
+	_height(height), _bFullScreen(bFullScreen), _bHeadless(bHeadless), _userData(nullptr) {}
+
+GLFWwindow* ST::AppWindow::CreateHeadlessWindow() {
+	static const int contextApis[] = {GLFW_EGL_CONTEXT_API, GLFW_OSMESA_CONTEXT_API, GLFW_NATIVE_CONTEXT_API};
+	GLFWwindow* window = nullptr;
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	for (int contextApi : contextApis) {
+		glfwWindowHint(GLFW_CONTEXT_CREATION_API, contextApi);
+		window = glfwCreateWindow(_width, _height, "Stellar", nullptr, nullptr);
+		if (window)
+			break;
+	}
+	glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_NATIVE_CONTEXT_API);
+	glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+	return window;
+}
 
 void ST::AppWindow::InitWindow(Application* app) {
 	glfwInit();
 	glfwInitHint(GL_MAJOR_VERSION, 3);
 	glfwInitHint(GL_MINOR_VERSION, 0);
 	glfwInitHint(GLFW_OPENGL_PROFILE,GLFW_OPENGL_CORE_PROFILE);
-	if (_bFullScreen) {
+	if (_bHeadless)
+		_window = CreateHeadlessWindow();
+	else if (_bFullScreen) {
 		GLFWmonitor* monitor    = glfwGetPrimaryMonitor();
 		const GLFWvidmode* mode = glfwGetVideoMode(monitor);
 		_width                  = mode->width;
@@ -58,6 +76,12 @@ void ST::AppWindow::InitWindow(Application* app) {
 		ST_LOG("Load Glad Failed!");
 		return;
 	}
+	if (_bHeadless) {
+		/* frames are timed, not presented */
+		glfwSwapInterval(0);
+	}
+	else
+		ResourceManager::GetResourceManager().EnableShaderHotReload(_window);
 	
 	glEnable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
@@ -88,33 +112,17 @@ void ST::AppWindow::InitWindow(Application* app) {
 	};
 	
 	
-	// _gameObjects.emplace_back(ST_MAKE_REF<GameObject>());
-	// _gameObjects.back()->SetModel(ST_MAKE_REF<Model>(ST_VECTOR<ST_REF<Mesh>>{cubeMesh}));
-	// _gameObjects.back()->_transform = Transform{};
-
-	_gameObjects.emplace_back(ST_MAKE_REF<GameObject>());
-	_gameObjects.back()->SetModel(ST_MAKE_REF<Model>(ST_VECTOR<ST_REF<Mesh>>{planeMesh}));
-	_gameObjects.back()->_transform = Transform{};
-
-	_gameObjects.emplace_back(ST_MAKE_REF<GameObject>());
-	_gameObjects.back()->SetModel(ST_MAKE_REF<Model>(ST_VECTOR<ST_REF<Mesh>>{cubeMesh}));
-	_gameObjects.back()->_transform = Transform{{10, 0, 0}, {}, {10, 10, 5}};
-
-	_gameObjects.emplace_back(ST_MAKE_REF<GameObject>());
-	_gameObjects.back()->SetModel(ST_MAKE_REF<Model>(ST_VECTOR<ST_REF<Mesh>>{cubeMesh}));
-	_gameObjects.back()->_transform = Transform{{10, -10, 10}};
-
-	_selectedGameObject = _gameObjects.back();
-	
-	_gameObjects.emplace_back(ST_MAKE_REF<GameObject>());
-	_gameObjects.back()->SetModel(ST_MAKE_REF<Model>(ST_VECTOR<ST_REF<Mesh>>{cubeMesh}));
-	_gameObjects.back()->_transform = Transform{{30, 20, 10}};
-	
+	auto spawn = [this](ST_REF<Model> model, const Transform& transform) {
+		return _world.CreateEntity(SceneNodeComponent{_transforms.Create(transform)}, RenderComponent{model},
+			BoundsComponent{});
+	};
 
-	_gameObjects.emplace_back(ST_MAKE_REF<GameObject>());
-	_gameObjects.back()->SetModel(
-		ResourceManager::GetResourceManager().LoadModel("/Resource/Model/nanosuit/nanosuit.obj"));
-	_gameObjects.back()->_transform = Transform{{}, {0, 0, 0},};
+	spawn(ST_MAKE_REF<Model>(ST_VECTOR<ST_REF<Mesh>>{planeMesh}), Transform{});
+	spawn(ST_MAKE_REF<Model>(ST_VECTOR<ST_REF<Mesh>>{cubeMesh}), Transform{{10, 0, 0}, {}, {10, 10, 5}});
+	_selectedEntity = spawn(ST_MAKE_REF<Model>(ST_VECTOR<ST_REF<Mesh>>{cubeMesh}), Transform{{10, -10, 10}});
+	spawn(ST_MAKE_REF<Model>(ST_VECTOR<ST_REF<Mesh>>{cubeMesh}), Transform{{30, 20, 10}});
+	spawn(ResourceManager::GetResourceManager().LoadModel("/Resource/Model/nanosuit/nanosuit.obj"),
+		Transform{{}, {0, 0, 0},});
 
 	_skyBox=cubeMesh;
 	
@@ -127,7 +135,7 @@ void ST::AppWindow::InitWindow(Application* app) {
 #pragma region /** BindEvent */
 	glfwSetWindowUserPointer(_window, _userData.get());
 	glfwSetFramebufferSizeCallback(_window, [](GLFWwindow* window, int width, int height) {
-		glViewport(0, 0, width, height);
+		/* the render thread sets the viewport from the packet */
 		const auto userData = static_cast<GLFWWindowData*>(glfwGetWindowUserPointer(window));
 		userData->_app->OnEvent(*userData->_appWindow, WindowResizedEvent(width, height));
 		userData->_appWindow->_width  = width;
@@ -196,14 +204,24 @@ void ST::AppWindow::InitWindow(Application* app) {
 	});
 #pragma endregion
 
-	ImguiPanel::Init(_window);
+	ImguiPanel::Init(_window, false);
 
+	_renderThread = ST_SCOPE<RenderThread>(new RenderThread(_window, [this](const FramePacket& packet) {
+		RenderPacket(packet);
+	}));
 }
 
 void ST::AppWindow::Tick(float deltaTime) {
+	/* InitWindow bailed out before the scene and the render thread were set up */
+	if (!_renderThread)
+		return;
 	_userData->deltaTime = deltaTime;
 	_cameraController->Tick(deltaTime);
 	_camera->UpdateCameraMat();
+	{
+		ST_PROFILE_SCOPE("TransformHierarchy::Update");
+		_transforms.Update();
+	}
 	glfwPollEvents();
 
 }
@@ -211,79 +229,129 @@ void ST::AppWindow::Tick(float deltaTime) {
 using namespace ST;
 
 void ST::AppWindow::Render() {
+	ST_PROFILE_SCOPE("AppWindow::Render");
+	if (!_renderThread)
+		return;
+	FramePacket& packet = _renderThread->BeginPacket();
+	packet._frameIndex = Profiler::GetProfiler().GetFrameIndex();
+	packet._width      = _width;
+	packet._height     = _height;
+	GetWindowSize(packet._windowXSize, packet._windowYSize);
+	Renderer3D::FillCameraBlock(*_camera, packet._camera);
+	packet._cameraFar = _camera->_far;
 
-	
+	ImguiPanel::NewFrame();
+	ImguiPanel::CreateProfilerPanel("Profiler");
+	ImguiPanel::CreateDirLightPanel("Dir Light", _renderer3D->_dirLight);
+	ImguiPanel::CreatePointLightPanel("Point Light", _renderer3D->_pointLight);
+	_renderer3D->FillLightBlock(packet._light);
+
+	_renderer3D->CollectDrawItems(_world, _transforms, _selectedEntity, _userData->_app->GetJobSystem(), packet);
+	_canvas->Draw(packet._uiDrawList);
+	ImguiPanel::EndFrame(packet._imgui);
+
+	_renderThread->SubmitPacket();
+}
+
+void ST::AppWindow::RenderPacket(const FramePacket& packet) {
+	ST_PROFILE_SCOPE("AppWindow::RenderPacket");
+	Profiler::GetProfiler().BeginGpuFrame(packet._frameIndex);
+	ResourceManager::GetResourceManager().UpdateTextureUploads();
+	ResourceManager::GetResourceManager().UpdateShaderReloads();
+
+	glViewport(0, 0, packet._width, packet._height);
 	glStencilMask(0xFF); // glStencilMask(0x00) cause clearing stencil buffer bit not work
 	_renderer3D->PostProcessRecordBegin();
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 	glDepthFunc(GL_LESS);
-	ImguiPanel::NewFrame();
+
+	_renderer3D->BeginFrame(packet);
 
 	/* Draw game objects */
-	glStencilFunc(GL_ALWAYS,0,0xFF);
-	glStencilMask(0x00);
-	_renderer3D->BeginDraw(ResourceManager::GetResourceManager().LoadShader(
-		"/Resource/OpenGLShader/BoxShader.vt.glsl",
-		"/Resource/OpenGLShader/BoxShader.fg.glsl"), _camera);
-	_renderer3D->SetLight();
-
-	for (auto& gameObject : _gameObjects) {
-		if(gameObject!=_selectedGameObject) {
-			_renderer3D->DrawGameObject(gameObject);
-		}
+	{
+		ST_PROFILE_PASS("Scene");
+		glStencilFunc(GL_ALWAYS,0,0xFF);
+		glStencilMask(0x00);
+		_renderer3D->BeginDraw(ResourceManager::GetResourceManager().LoadShader(
+			"/Resource/OpenGLShader/BoxShader.vt.glsl",
+			"/Resource/OpenGLShader/BoxShader.fg.glsl"));
+		_renderer3D->SubmitDrawItems(packet._sceneItems);
+	}
+	{
+		ST_PROFILE_PASS("SkyBox");
+		glDepthFunc(GL_LEQUAL);
+		_renderer3D->BeginDraw(ResourceManager::GetResourceManager().LoadShader(
+			"/Resource/OpenGLShader/SkyBox.vt.glsl",
+			"/Resource/OpenGLShader/SkyBox.fg.glsl"));
+		_renderer3D->DrawSkyBox(_skyBox);
+		glDepthFunc(GL_LESS);
 	}
-	glDepthFunc(GL_LEQUAL);
-	_renderer3D->BeginDrawSkyBox(ResourceManager::GetResourceManager().LoadShader(
-		"/Resource/OpenGLShader/SkyBox.vt.glsl",
-		"/Resource/OpenGLShader/SkyBox.fg.glsl"), _camera);
-	_renderer3D->DrawSkyBox(_skyBox);
-	glDepthFunc(GL_LESS);
 
 	/* Draw selected game obj*/
-	glStencilFunc(GL_ALWAYS,1,0xFF);
-	glStencilMask(0xFF);
-	_renderer3D->DrawGameObject(_selectedGameObject);
-	
-	glStencilFunc(GL_NOTEQUAL,1,0xFF);
-	glStencilMask(0x00);
-	glDisable(GL_DEPTH_TEST);
-	_renderer3D->BeginDraw(ResourceManager::GetResourceManager().LoadShader(
-		"/Resource/OpenGLShader/PureColorShader.vt.glsl",
-		"/Resource/OpenGLShader/PureColorShader.fg.glsl"), _camera);
-
-	// _renderer3D->DrawScaledGameObjectByColor(_selectedGameObject,
-	// 	{1.2, 1.2, 1.2}, {1, 1, 1, 1});
-	glEnable(GL_DEPTH_TEST);
+	{
+		ST_PROFILE_PASS("Outline");
+		glStencilFunc(GL_ALWAYS,1,0xFF);
+		glStencilMask(0xFF);
+		_renderer3D->SubmitDrawItems(packet._selectedItems);
+		
+		glStencilFunc(GL_NOTEQUAL,1,0xFF);
+		glStencilMask(0x00);
+		glDisable(GL_DEPTH_TEST);
+		_renderer3D->BeginDraw(ResourceManager::GetResourceManager().LoadShader(
+			"/Resource/OpenGLShader/PureColorShader.vt.glsl",
+			"/Resource/OpenGLShader/PureColorShader.fg.glsl"));
+
+		// _renderer3D->DrawScaledGameObjectByColor(_selectedGameObject,
+		// 	{1.2, 1.2, 1.2}, {1, 1, 1, 1});
+		glEnable(GL_DEPTH_TEST);
+	}
 	
 	// _renderer3D->BeginDraw(ResourceManager::GetResourceManager().LoadShader(
 	// 	"/Resource/OpenGLShader/Lighting.vt.glsl",
-	// 	"/Resource/OpenGLShader/Lighting.fg.glsl"), _camera);
+	// 	"/Resource/OpenGLShader/Lighting.fg.glsl"));
 	// _renderer3D->DrawLight(mesh, _camera);
 
 	/* Draw UI */
-	glDisable(GL_DEPTH_TEST);
-	glDepthFunc(GL_ALWAYS);
-	_canvas->Draw(_renderer2D);
-	glEnable(GL_DEPTH_TEST);
+	{
+		ST_PROFILE_PASS("UI");
+		glDisable(GL_DEPTH_TEST);
+		glDepthFunc(GL_ALWAYS);
+		_renderer2D->BeginDraw(packet._windowXSize, packet._windowYSize);
+		packet._uiDrawList.Replay(*_renderer2D);
+		_renderer2D->EndDraw();
+		glEnable(GL_DEPTH_TEST);
+	}
 
 	/* Post process */
-	_renderer3D->PostProcessRecordEnd();
-	// // Post Processing
-	glDisable(GL_DEPTH_TEST);
-	//glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
-	glClear(GL_COLOR_BUFFER_BIT);
-	_renderer3D->BeginDraw(ResourceManager::GetResourceManager().LoadShader(
-		"/Resource/OpenGLShader/PostProcessingShader.vt.glsl",
-		"/Resource/OpenGLShader/PostProcessingShader.fg.glsl"), _camera);
-	_renderer3D->BeginPostProcess();
-	_renderer3D->DrawQuad(_postProcessingQuad);
-	glEnable(GL_DEPTH_TEST);
+	{
+		ST_PROFILE_PASS("PostProcess");
+		_renderer3D->PostProcessRecordEnd();
+		// // Post Processing
+		glDisable(GL_DEPTH_TEST);
+		//glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+		glClear(GL_COLOR_BUFFER_BIT);
+		_renderer3D->BeginDraw(ResourceManager::GetResourceManager().LoadShader(
+			"/Resource/OpenGLShader/PostProcessingShader.vt.glsl",
+			"/Resource/OpenGLShader/PostProcessingShader.fg.glsl"));
+		_renderer3D->BeginPostProcess();
+		_renderer3D->DrawQuad(_postProcessingQuad);
+		glEnable(GL_DEPTH_TEST);
+	}
 
-	ImguiPanel::Render();
+	{
+		ST_PROFILE_PASS("ImGui");
+		ImguiPanel::RenderSnapshot(packet._imgui);
+	}
 	glfwSwapBuffers(_window);
 }
 
 void ST::AppWindow::Destroy() {
+	if (!_renderThread)
+		return;
+	/* finishes the last packet and hands the context back for the cleanup below */
+	_renderThread.reset();
+	ResourceManager::GetResourceManager().ShutdownTextureLoader();
+	ResourceManager::GetResourceManager().DisableShaderHotReload();
 	ImguiPanel::Close();
 }
 
@@ -2,7 +2,10 @@
 
 #include "Core.h"
 #include "Event/EventCode.h"
+#include "ECS/World.h"
+#include "Math/TransformHierarchy.h"
 #include "Render/Renderer3D.h"
+#include "Render/RenderThread.h"
 
 /*
  * Transmit event to app
@@ -21,12 +24,13 @@ class Canvas;
 class AppWindow //:public std::enable_shared_from_this<AppWindow>
 {
 public:
-	AppWindow(int width, int height, bool bFullScreen);
+	AppWindow(int width, int height, bool bFullScreen, bool bHeadless = false);
 
 	void InitWindow(Application* app);
 
 	void Tick(float deltaTime);
 
+	/* Builds this frame's packet and hands it to the render thread, which is still drawing the previous one */
 	void Render();
 
 	void Destroy();
@@ -37,6 +41,10 @@ public:
 
 	double GetCurrentWindowTime() const;
 
+	inline bool IsHeadless() const {
+		return _bHeadless;
+	}
+
 	ST_EVENT_ACTION GetKeyAction(ST_KEY_TYPE key);
 
 	int _width;
@@ -48,6 +56,14 @@ private:
 
 	bool _bFullScreen;
 
+	bool _bHeadless;
+
+	/* Hidden window, tries EGL then OSMesa (llvmpipe on Mesa) before the platform's native context */
+	GLFWwindow* CreateHeadlessWindow();
+
+	/* Render thread, every GL call of a frame happens in here */
+	void RenderPacket(const FramePacket& packet);
+
 	struct GLFWWindowData {
 		Application* _app{};
 
@@ -73,12 +89,19 @@ private:
 
 	ST_REF<CameraController> _cameraController;
 
-	ST_VECTOR<ST_REF<GameObject>> _gameObjects;
+	/* Scene entities, drawn through Renderer3D::CollectDrawItems */
+	World _world;
+
+	/* World matrices of the scene entities, updated in Tick */
+	TransformHierarchy _transforms;
 
 	ST_REF<Mesh> _skyBox;
 
-	ST_REF<GameObject> _selectedGameObject;
+	Entity _selectedEntity;
 
 	ST_REF<Mesh> _postProcessingQuad;
+
+	/* Owns the GL context from the end of InitWindow until Destroy */
+	ST_SCOPE<RenderThread> _renderThread;
 };
 }
@@ -1,9 +1,16 @@
 #include "Application.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
 #include "AppWindow.h"
 #include "Core.h"
 #include "PathManager.h"
 
-ST::Application::Application(): _shouldClose(false), _window(ST_MAKE_REF<AppWindow>(600, 400, false)) {}
+ST::Application::Application(bool bHeadless): _shouldClose(false),
+	_window(ST_MAKE_REF<AppWindow>(600, 400, false, bHeadless)),
+	_jobSystem(new JobSystem(std::max(std::thread::hardware_concurrency(), 1u) - 1)) {}
 
 void ST::Application::Init() {
 	_window->InitWindow(this);
@@ -24,6 +31,21 @@ void ST::Application::Destroy() {
 	_window->Destroy();
 }
 
+void ST::Application::RunFixedSteps(float deltaTime) {
+	_fixedTimeAccumulator += deltaTime;
+	uint32_t steps = 0;
+	while (_fixedTimeAccumulator >= _fixedTimeStep && steps < _maxFixedSteps) {
+		FixedTick(_fixedTimeStep);
+		_fixedTimeAccumulator -= _fixedTimeStep;
+		++steps;
+	}
+	if (_fixedTimeAccumulator >= _fixedTimeStep) {
+		/* fell behind, drop the backlog rather than catching up next frame */
+		_fixedTimeAccumulator = std::fmod(_fixedTimeAccumulator, _fixedTimeStep);
+	}
+	_fixedStepAlpha = _fixedTimeAccumulator / _fixedTimeStep;
+}
+
 float ST::Application::GetAPPCurrentTime() {
 	return _window->GetCurrentWindowTime();
 }
@@ -1,19 +1,25 @@
 #pragma once
 #include "Event/Event.h"
+#include "JobSystem.h"
 
 namespace ST {
 class AppWindow;
 
 class Application {
 public:
-	Application();
+	/* bHeadless renders into a hidden window, for benchmarks and machines without a desktop */
+	explicit Application(bool bHeadless = false);
 
 	virtual ~Application() {}
 
 	virtual void Init();
 
+	/* Once per frame with the wall clock delta, for input and camera */
 	virtual void Tick(float deltaTime);
 
+	/* Simulation step, called zero or more times per frame with a constant delta before Render */
+	virtual void FixedTick(float) {}
+
 	virtual void Render(float deltaTime);
 
 	virtual void Destroy();
@@ -24,6 +30,47 @@ public:
 
 	virtual float GetAPPCurrentTime();
 
+	/* The delta the main loop hands to Tick, RunFixedSteps and Render. The wall clock one by default, overridden to
+	   replay frames at a fixed rate */
+	virtual float GetFrameDeltaTime(float wallDeltaTime) {
+		return wallDeltaTime;
+	}
+
+	/* Accumulates deltaTime and runs the FixedTick steps it covers, at most _maxFixedSteps of them */
+	void RunFixedSteps(float deltaTime);
+
+	/* How far the accumulator is into the next fixed step, 0..1, Render blends the last two states by it */
+	inline float GetFixedStepAlpha() const {
+		return _fixedStepAlpha;
+	}
+
+	inline float GetFixedTimeStep() const {
+		return _fixedTimeStep;
+	}
+
+	void SetFixedTimeStep(float fixedTimeStep) {
+		_fixedTimeStep = fixedTimeStep;
+	}
+
+	/* Steps beyond this in one frame are dropped so a hitch slows the simulation down instead of spiralling */
+	void SetMaxFixedSteps(uint32_t maxFixedSteps) {
+		_maxFixedSteps = maxFixedSteps;
+	}
+
+	/* 0 runs unpaced, otherwise the main loop sleeps off the rest of each frame */
+	void SetTargetFrameRate(float frameRate) {
+		_targetFrameTime = frameRate > 0 ? 1.f / frameRate : 0.f;
+	}
+
+	inline float GetTargetFrameTime() const {
+		return _targetFrameTime;
+	}
+
+	/* Shared by every subsystem that fans work out, one worker per core besides the main thread */
+	inline JobSystem& GetJobSystem() {
+		return *_jobSystem;
+	}
+
 #pragma region /** Event */
 	void OnEvent(const AppWindow& appWindow, const Event& e);
 
@@ -38,5 +85,17 @@ protected:
 
 	ST_REF<AppWindow> _window;
 
+	ST_SCOPE<JobSystem> _jobSystem;
+
+	float _fixedTimeStep = 1.f / 60.f;
+
+	uint32_t _maxFixedSteps = 5;
+
+	float _fixedTimeAccumulator = 0.f;
+
+	float _fixedStepAlpha = 0.f;
+
+	float _targetFrameTime = 0.f;
+
 };
 }
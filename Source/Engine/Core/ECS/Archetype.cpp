@@ -0,0 +1,95 @@
+#include "Archetype.h"
+
+#include <algorithm>
+
+namespace {
+size_t AlignUp(size_t offset, size_t alignment) {
+	return (offset + alignment - 1) / alignment * alignment;
+}
+}
+
+ST::Archetype::Archetype(ComponentMask mask): _mask(mask) {
+	std::fill(std::begin(_columnOfComponent), std::end(_columnOfComponent), static_cast<int8_t>(-1));
+	size_t rowBytes = sizeof(Entity);
+	for (ComponentId id = 0; id < MAX_COMPONENT_TYPES; ++id) {
+		if (!Has(id))
+			continue;
+		_columnOfComponent[id] = static_cast<int8_t>(_columns.size());
+		_columns.push_back(Column{id, 0, ComponentRegistry::GetInfo(id)._size});
+		rowBytes += _columns.back()._size;
+	}
+
+	/* the first guess ignores alignment padding between the arrays, shrink until everything fits */
+	uint32_t capacity = static_cast<uint32_t>(CHUNK_BYTES / rowBytes);
+	while (capacity > 0) {
+		size_t offset = sizeof(Entity) * capacity;
+		for (auto& column : _columns) {
+			offset          = AlignUp(offset, ComponentRegistry::GetInfo(column._id)._alignment);
+			column._offset  = offset;
+			offset         += column._size * capacity;
+		}
+		if (offset <= CHUNK_BYTES)
+			break;
+		--capacity;
+	}
+	/* not an assert, rows are addressed by dividing by the capacity */
+	if (capacity == 0)
+		ST_ERROR("Archetype row does not fit in a chunk\n");
+	_chunkCapacity = capacity;
+}
+
+ST::Archetype::~Archetype() {
+	while (_entityCount > 0) {
+		RemoveRow(_entityCount - 1);
+	}
+	for (uint8_t* chunk : _chunks) {
+		::operator delete(chunk);
+	}
+}
+
+void* ST::Archetype::GetChunkComponents(uint32_t chunk, ComponentId id) const {
+	int8_t column = _columnOfComponent[id];
+	return column < 0 ? nullptr : _chunks[chunk] + _columns[column]._offset;
+}
+
+void* ST::Archetype::GetComponent(uint32_t row, ComponentId id) const {
+	int8_t column = _columnOfComponent[id];
+	return column < 0 ? nullptr : GetCell(row, _columns[column]);
+}
+
+uint32_t ST::Archetype::AddRow(Entity entity) {
+	uint32_t row = _entityCount;
+	if (row == _chunks.size() * _chunkCapacity) {
+		/* operator new is aligned for max_align_t, which ComponentRegistry holds every component to */
+		_chunks.push_back(static_cast<uint8_t*>(::operator new(CHUNK_BYTES)));
+	}
+	GetChunkEntities(row / _chunkCapacity)[row % _chunkCapacity] = entity;
+	++_entityCount;
+	return row;
+}
+
+ST::Entity ST::Archetype::RemoveRow(uint32_t row) {
+	uint32_t last = _entityCount - 1;
+	for (auto& column : _columns) {
+		ComponentRegistry::GetInfo(column._id)._destroy(GetCell(row, column));
+	}
+
+	Entity moved;
+	if (row != last) {
+		for (auto& column : _columns) {
+			const ComponentInfo& info = ComponentRegistry::GetInfo(column._id);
+			info._moveConstruct(GetCell(row, column), GetCell(last, column));
+			info._destroy(GetCell(last, column));
+		}
+		moved = GetEntity(last);
+		GetChunkEntities(row / _chunkCapacity)[row % _chunkCapacity] = moved;
+	}
+
+	--_entityCount;
+	/* keep one spare chunk around so an entity hopping in and out does not allocate every time */
+	if (_chunks.size() > 1 && _entityCount <= (_chunks.size() - 2) * _chunkCapacity) {
+		::operator delete(_chunks.back());
+		_chunks.pop_back();
+	}
+	return moved;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <algorithm>
+
+#include "Core.h"
+#include "Component.h"
+#include "Entity.h"
+
+namespace ST {
+/*
+ * Entities that have exactly the same components. Rows are packed into fixed size chunks, and each chunk keeps
+ * one contiguous array per component next to the array of entities, so a query walks plain arrays.
+ */
+class Archetype {
+public:
+	static constexpr size_t CHUNK_BYTES = 16 * 1024;
+
+	explicit Archetype(ComponentMask mask);
+
+	~Archetype();
+
+	Archetype(const Archetype&) = delete;
+
+	Archetype& operator=(const Archetype&) = delete;
+
+	inline ComponentMask GetMask() const {
+		return _mask;
+	}
+
+	inline bool Has(ComponentId id) const {
+		return (_mask >> id & 1) != 0;
+	}
+
+	inline uint32_t GetEntityCount() const {
+		return _entityCount;
+	}
+
+	inline uint32_t GetChunkCapacity() const {
+		return _chunkCapacity;
+	}
+
+	/* Chunks holding at least one entity, a spare empty chunk may be allocated past them */
+	inline uint32_t GetChunkCount() const {
+		return (_entityCount + _chunkCapacity - 1) / _chunkCapacity;
+	}
+
+	/* Every chunk but the last one is full */
+	inline uint32_t GetChunkEntityCount(uint32_t chunk) const {
+		return std::min(_chunkCapacity, _entityCount - chunk * _chunkCapacity);
+	}
+
+	inline Entity* GetChunkEntities(uint32_t chunk) const {
+		return reinterpret_cast<Entity*>(_chunks[chunk]);
+	}
+
+	/* nullptr when the archetype does not have the component */
+	void* GetChunkComponents(uint32_t chunk, ComponentId id) const;
+
+	template <typename T>
+	T* GetChunkComponents(uint32_t chunk) const {
+		return static_cast<T*>(GetChunkComponents(chunk, GetComponentId<T>()));
+	}
+
+	inline Entity GetEntity(uint32_t row) const {
+		return GetChunkEntities(row / _chunkCapacity)[row % _chunkCapacity];
+	}
+
+	void* GetComponent(uint32_t row, ComponentId id) const;
+
+	/* Appends a row for entity, its components are left unconstructed for the caller */
+	uint32_t AddRow(Entity entity);
+
+	/* Destroys the row's components and fills the hole with the last row, returns the entity that moved into it */
+	Entity RemoveRow(uint32_t row);
+
+private:
+	struct Column {
+		ComponentId _id;
+
+		size_t _offset;
+
+		size_t _size;
+	};
+
+	inline uint8_t* GetCell(uint32_t row, const Column& column) const {
+		return _chunks[row / _chunkCapacity] + column._offset + (row % _chunkCapacity) * column._size;
+	}
+
+	ComponentMask _mask;
+
+	ST_VECTOR<Column> _columns;
+
+	/* Column index per component id, -1 when missing */
+	int8_t _columnOfComponent[MAX_COMPONENT_TYPES];
+
+	uint32_t _chunkCapacity = 0;
+
+	uint32_t _entityCount = 0;
+
+	ST_VECTOR<uint8_t*> _chunks;
+};
+}
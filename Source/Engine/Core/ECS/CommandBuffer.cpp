@@ -0,0 +1,59 @@
+#include "CommandBuffer.h"
+
+#include "World.h"
+
+ST::CommandBuffer::~CommandBuffer() {
+	Clear();
+}
+
+ST::Entity ST::CommandBuffer::CreateEntity() {
+	Entity entity = _world.ReserveEntity();
+	_commands.push_back(Command{CommandType::CREATE_ENTITY, entity, 0, nullptr});
+	return entity;
+}
+
+void ST::CommandBuffer::DestroyEntity(Entity entity) {
+	_commands.push_back(Command{CommandType::DESTROY_ENTITY, entity, 0, nullptr});
+}
+
+void ST::CommandBuffer::Playback() {
+	for (auto& command : _commands) {
+		switch (command._type) {
+			case CommandType::CREATE_ENTITY: _world.CreateReservedEntity(command._entity);
+				break;
+			case CommandType::DESTROY_ENTITY: _world.DestroyEntity(command._entity);
+				break;
+			case CommandType::ADD_COMPONENT: _world.AddComponent(command._entity, command._componentId,
+					command._payload);
+				break;
+			case CommandType::REMOVE_COMPONENT: _world.RemoveComponent(command._entity, command._componentId);
+				break;
+		}
+	}
+	Clear();
+}
+
+void ST::CommandBuffer::Clear() {
+	/* played back payloads were moved from but still need their destructor */
+	for (auto& command : _commands) {
+		/* entities of a buffer dropped without Playback give their index back */
+		if (command._type == CommandType::CREATE_ENTITY)
+			_world.ReleaseReservedEntity(command._entity);
+		if (command._payload)
+			ComponentRegistry::GetInfo(command._componentId)._destroy(command._payload);
+	}
+	_commands.clear();
+	_payloadBlocks.clear();
+	_payloadBlockUsed = PAYLOAD_BLOCK_BYTES;
+}
+
+void* ST::CommandBuffer::AllocatePayload(size_t size, size_t alignment) {
+	/* new[] storage is aligned for max_align_t, the same limit ComponentRegistry puts on components */
+	size_t offset = (_payloadBlockUsed + alignment - 1) / alignment * alignment;
+	if (offset + size > PAYLOAD_BLOCK_BYTES) {
+		_payloadBlocks.emplace_back(new uint8_t[size > PAYLOAD_BLOCK_BYTES ? size : PAYLOAD_BLOCK_BYTES]);
+		offset = 0;
+	}
+	_payloadBlockUsed = offset + size;
+	return _payloadBlocks.back().get() + offset;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Core.h"
+#include "Component.h"
+#include "Entity.h"
+
+namespace ST {
+class World;
+
+/*
+ * Structural changes recorded while a query iterates and applied by Playback in record order. Commands aimed
+ * at an entity that died in the meantime are dropped.
+ */
+class CommandBuffer {
+public:
+	explicit CommandBuffer(World& world): _world(world) {}
+
+	~CommandBuffer();
+
+	CommandBuffer(const CommandBuffer&) = delete;
+
+	CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+	/* The handle is reserved right away so later commands in this buffer can refer to it, the entity is created
+	   without components by Playback */
+	Entity CreateEntity();
+
+	void DestroyEntity(Entity entity);
+
+	template <typename T>
+	void AddComponent(Entity entity, T component) {
+		void* payload = AllocatePayload(sizeof(T), alignof(T));
+		new(payload) T(std::move(component));
+		_commands.push_back(Command{CommandType::ADD_COMPONENT, entity, GetComponentId<T>(), payload});
+	}
+
+	template <typename T>
+	void RemoveComponent(Entity entity) {
+		_commands.push_back(Command{CommandType::REMOVE_COMPONENT, entity, GetComponentId<T>(), nullptr});
+	}
+
+	void Playback();
+
+	inline bool IsEmpty() const {
+		return _commands.empty();
+	}
+
+private:
+	static constexpr size_t PAYLOAD_BLOCK_BYTES = 16 * 1024;
+
+	enum class CommandType : uint8_t {
+		CREATE_ENTITY,
+		DESTROY_ENTITY,
+		ADD_COMPONENT,
+		REMOVE_COMPONENT
+	};
+
+	struct Command {
+		CommandType _type;
+
+		Entity _entity;
+
+		ComponentId _componentId;
+
+		void* _payload;
+	};
+
+	/* Payloads live in blocks that never move, components are not required to be trivially relocatable */
+	void* AllocatePayload(size_t size, size_t alignment);
+
+	void Clear();
+
+	World& _world;
+
+	ST_VECTOR<Command> _commands;
+
+	ST_VECTOR<ST_SCOPE<uint8_t[]>> _payloadBlocks;
+
+	size_t _payloadBlockUsed = PAYLOAD_BLOCK_BYTES;
+};
+}
@@ -0,0 +1,23 @@
+#include "Component.h"
+
+#include <atomic>
+#include <cstddef>
+
+namespace {
+/* Fixed storage so GetInfo references stay valid while another thread registers a type */
+ST::ComponentInfo s_componentInfos[ST::MAX_COMPONENT_TYPES];
+
+std::atomic<ST::ComponentId> s_componentCount{0};
+}
+
+ST::ComponentId ST::ComponentRegistry::Register(const ComponentInfo& info) {
+	ComponentId id = s_componentCount.fetch_add(1);
+	ST_ASSERT(id < MAX_COMPONENT_TYPES, "Too many component types\n");
+	ST_ASSERT(info._alignment <= alignof(std::max_align_t), "Component alignment is not supported by chunks\n");
+	s_componentInfos[id] = info;
+	return id;
+}
+
+const ST::ComponentInfo& ST::ComponentRegistry::GetInfo(ComponentId id) {
+	return s_componentInfos[id];
+}
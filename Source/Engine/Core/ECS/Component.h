@@ -0,0 +1,54 @@
+#pragma once
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "Core.h"
+
+namespace ST {
+using ComponentId = uint32_t;
+
+/* One bit per component id, an archetype is the set of components its entities have */
+using ComponentMask = uint64_t;
+
+constexpr ComponentId MAX_COMPONENT_TYPES = 64;
+
+/* Type erased lifetime of a component, chunks hold raw bytes and go through these to move or destroy them */
+struct ComponentInfo {
+	size_t _size;
+
+	size_t _alignment;
+
+	void (*_moveConstruct)(void* dst, void* src);
+
+	void (*_destroy)(void* component);
+};
+
+class ComponentRegistry {
+public:
+	static ComponentId Register(const ComponentInfo& info);
+
+	static const ComponentInfo& GetInfo(ComponentId id);
+};
+
+/* Ids are handed out on first use, so they are only stable within one run */
+template <typename T>
+ComponentId GetComponentId() {
+	static_assert(std::is_same<T, typename std::decay<T>::type>::value, "Components are plain value types");
+	static const ComponentId id = ComponentRegistry::Register(ComponentInfo{
+		sizeof(T), alignof(T),
+		[](void* dst, void* src) { new(dst) T(std::move(*static_cast<T*>(src))); },
+		[](void* component) { static_cast<T*>(component)->~T(); }
+	});
+	return id;
+}
+
+template <typename... Ts>
+ComponentMask MakeComponentMask() {
+	ComponentMask mask = 0;
+	int expand[] = {0, (mask |= ComponentMask(1) << GetComponentId<Ts>(), 0)...};
+	(void)expand;
+	return mask;
+}
+}
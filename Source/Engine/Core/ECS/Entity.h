@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Core.h"
+
+namespace ST {
+/*
+ * Index in the low 20 bits, generation in the high 12, packed like ResourceHandle. Destroying an entity bumps
+ * the generation of its slot, so copies of the old handle stop being alive.
+ */
+struct Entity {
+	static constexpr uint32_t INDEX_BITS      = 20;
+	static constexpr uint32_t INDEX_MASK      = (1u << INDEX_BITS) - 1;
+	static constexpr uint32_t GENERATION_MASK = (1u << (32 - INDEX_BITS)) - 1;
+
+	Entity() = default;
+
+	Entity(uint32_t index, uint32_t generation): _value(generation << INDEX_BITS | index) {}
+
+	inline bool IsValid() const {
+		return _value != 0;
+	}
+
+	inline uint32_t GetIndex() const {
+		return _value & INDEX_MASK;
+	}
+
+	inline uint32_t GetGeneration() const {
+		return _value >> INDEX_BITS;
+	}
+
+	inline bool operator==(const Entity& other) const {
+		return _value == other._value;
+	}
+
+	inline bool operator!=(const Entity& other) const {
+		return _value != other._value;
+	}
+
+	uint32_t _value = 0;
+};
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Core.h"
+#include "Math/Bounds.h"
+#include "Math/TransformHierarchy.h"
+
+namespace ST {
+class Model;
+
+/* The entity's node in the scene TransformHierarchy, which owns its local and world matrices */
+struct SceneNodeComponent {
+	TransformNode _node = INVALID_TRANSFORM_NODE;
+};
+
+/* Drawn by Renderer3D::CollectDrawItems at the world matrix of the entity's SceneNodeComponent */
+struct RenderComponent {
+	ST_REF<Model> _model;
+};
+
+/* World space bounds of the RenderComponent model, refreshed by Renderer3D::CollectDrawItems when the node moved */
+struct BoundsComponent {
+	Bounds _world;
+};
+}
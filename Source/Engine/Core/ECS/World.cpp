@@ -0,0 +1,152 @@
+#include "World.h"
+
+ST::World::World() {
+	GetOrCreateArchetype(0);
+}
+
+ST::World::~World() {
+	/* archetypes destroy their remaining components */
+	_archetypes.clear();
+}
+
+ST::Entity ST::World::CreateEntity() {
+	ST_ASSERT(_queryDepth == 0, "Structural change while iterating, use a CommandBuffer\n");
+	return AllocateEntity(_archetypeByMask[0]);
+}
+
+ST::Entity ST::World::ReserveEntity() {
+	uint32_t index = AllocateIndex();
+	return Entity(index, _records[index]._generation);
+}
+
+void ST::World::CreateReservedEntity(Entity entity) {
+	ST_ASSERT(_queryDepth == 0, "Structural change while iterating, use a CommandBuffer\n");
+	if (!IsReserved(entity))
+		return;
+	Archetype* archetype = _archetypeByMask[0];
+	EntityRecord& record = _records[entity.GetIndex()];
+	record._archetype    = archetype;
+	record._row          = archetype->AddRow(entity);
+	++_entityCount;
+}
+
+void ST::World::ReleaseReservedEntity(Entity entity) {
+	if (IsReserved(entity))
+		FreeIndex(entity.GetIndex());
+}
+
+bool ST::World::IsReserved(Entity entity) const {
+	uint32_t index = entity.GetIndex();
+	return entity.IsValid() && index < _records.size() && !_records[index]._archetype &&
+		_records[index]._generation == entity.GetGeneration();
+}
+
+uint32_t ST::World::AllocateIndex() {
+	if (!_freeIndices.empty()) {
+		uint32_t index = _freeIndices.back();
+		_freeIndices.pop_back();
+		return index;
+	}
+	ST_ASSERT(_records.size() <= Entity::INDEX_MASK, "World is full\n");
+	_records.emplace_back();
+	return static_cast<uint32_t>(_records.size() - 1);
+}
+
+void ST::World::FreeIndex(uint32_t index) {
+	EntityRecord& record = _records[index];
+	record._archetype    = nullptr;
+	/* skip 0 on wrap around so a zero handle stays invalid */
+	record._generation = (record._generation & Entity::GENERATION_MASK) == Entity::GENERATION_MASK
+		? 1
+		: record._generation + 1;
+	_freeIndices.push_back(index);
+}
+
+ST::Entity ST::World::AllocateEntity(Archetype* archetype) {
+	uint32_t index       = AllocateIndex();
+	EntityRecord& record = _records[index];
+	Entity entity(index, record._generation);
+	record._archetype = archetype;
+	record._row       = archetype->AddRow(entity);
+	++_entityCount;
+	return entity;
+}
+
+void ST::World::DestroyEntity(Entity entity) {
+	ST_ASSERT(_queryDepth == 0, "Structural change while iterating, use a CommandBuffer\n");
+	if (!IsAlive(entity))
+		return;
+	EntityRecord& record = _records[entity.GetIndex()];
+	Entity moved         = record._archetype->RemoveRow(record._row);
+	if (moved.IsValid())
+		_records[moved.GetIndex()]._row = record._row;
+	FreeIndex(entity.GetIndex());
+	--_entityCount;
+}
+
+bool ST::World::IsAlive(Entity entity) const {
+	uint32_t index = entity.GetIndex();
+	return entity.IsValid() && index < _records.size() && _records[index]._archetype &&
+		_records[index]._generation == entity.GetGeneration();
+}
+
+void* ST::World::AddComponent(Entity entity, ComponentId id, void* component) {
+	if (!IsAlive(entity))
+		return nullptr;
+	const ComponentInfo& info = ComponentRegistry::GetInfo(id);
+	EntityRecord& record      = _records[entity.GetIndex()];
+	if (record._archetype->Has(id)) {
+		void* existing = record._archetype->GetComponent(record._row, id);
+		info._destroy(existing);
+		info._moveConstruct(existing, component);
+		return existing;
+	}
+
+	ST_ASSERT(_queryDepth == 0, "Structural change while iterating, use a CommandBuffer\n");
+	MoveEntity(entity, GetOrCreateArchetype(record._archetype->GetMask() | ComponentMask(1) << id));
+	void* added = record._archetype->GetComponent(record._row, id);
+	info._moveConstruct(added, component);
+	return added;
+}
+
+void ST::World::RemoveComponent(Entity entity, ComponentId id) {
+	if (!IsAlive(entity) || !_records[entity.GetIndex()]._archetype->Has(id))
+		return;
+	ST_ASSERT(_queryDepth == 0, "Structural change while iterating, use a CommandBuffer\n");
+	EntityRecord& record = _records[entity.GetIndex()];
+	MoveEntity(entity, GetOrCreateArchetype(record._archetype->GetMask() & ~(ComponentMask(1) << id)));
+}
+
+void* ST::World::GetComponent(Entity entity, ComponentId id) const {
+	if (!IsAlive(entity))
+		return nullptr;
+	const EntityRecord& record = _records[entity.GetIndex()];
+	return record._archetype->GetComponent(record._row, id);
+}
+
+ST::Archetype* ST::World::GetOrCreateArchetype(ComponentMask mask) {
+	auto it = _archetypeByMask.find(mask);
+	if (it != _archetypeByMask.end())
+		return it->second;
+	_archetypes.emplace_back(new Archetype(mask));
+	_archetypeByMask[mask] = _archetypes.back().get();
+	return _archetypes.back().get();
+}
+
+void ST::World::MoveEntity(Entity entity, Archetype* target) {
+	EntityRecord& record = _records[entity.GetIndex()];
+	Archetype* source    = record._archetype;
+	uint32_t targetRow   = target->AddRow(entity);
+	for (ComponentId id = 0; id < MAX_COMPONENT_TYPES; ++id) {
+		if (source->Has(id) && target->Has(id)) {
+			ComponentRegistry::GetInfo(id)._moveConstruct(target->GetComponent(targetRow, id),
+				source->GetComponent(record._row, id));
+		}
+	}
+	/* the moved from components are destroyed with the old row */
+	Entity moved = source->RemoveRow(record._row);
+	if (moved.IsValid())
+		_records[moved.GetIndex()]._row = record._row;
+	record._archetype = target;
+	record._row       = targetRow;
+}
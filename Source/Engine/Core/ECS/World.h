@@ -0,0 +1,182 @@
+#pragma once
+
+#include "Core.h"
+#include "JobSystem.h"
+#include "Archetype.h"
+#include "Component.h"
+#include "Entity.h"
+
+namespace ST {
+/*
+ * Entities grouped into archetypes by their component set. Adding or removing a component moves the entity
+ * to another archetype, which is a structural change: it is not allowed while a query is iterating, record it
+ * in a CommandBuffer instead.
+ */
+class World {
+public:
+	World();
+
+	~World();
+
+	World(const World&) = delete;
+
+	World& operator=(const World&) = delete;
+
+	/* Entity without components */
+	Entity CreateEntity();
+
+	/* Takes an index and generation without adding a row, so it is safe during a query. The entity is not alive
+	   until CreateReservedEntity, or goes back to the free list with ReleaseReservedEntity */
+	Entity ReserveEntity();
+
+	void CreateReservedEntity(Entity entity);
+
+	/* No-op once the entity was created */
+	void ReleaseReservedEntity(Entity entity);
+
+	template <typename... Ts>
+	Entity CreateEntity(Ts&&... components) {
+		ST_ASSERT(_queryDepth == 0, "Structural change while iterating, use a CommandBuffer\n");
+		Archetype* archetype = GetOrCreateArchetype(MakeComponentMask<typename std::decay<Ts>::type...>());
+		Entity entity        = AllocateEntity(archetype);
+		uint32_t row         = _records[entity.GetIndex()]._row;
+		int expand[]         = {0, (ConstructComponent(archetype, row, std::forward<Ts>(components)), 0)...};
+		(void)expand;
+		return entity;
+	}
+
+	void DestroyEntity(Entity entity);
+
+	bool IsAlive(Entity entity) const;
+
+	inline uint32_t GetEntityCount() const {
+		return _entityCount;
+	}
+
+	/* Overwrites the component if the entity already has one */
+	template <typename T>
+	T& AddComponent(Entity entity, T component) {
+		return *static_cast<T*>(AddComponent(entity, GetComponentId<T>(), &component));
+	}
+
+	template <typename T>
+	void RemoveComponent(Entity entity) {
+		RemoveComponent(entity, GetComponentId<T>());
+	}
+
+	/* nullptr for a dead entity or a missing component, invalidated by the next structural change */
+	template <typename T>
+	T* GetComponent(Entity entity) const {
+		return static_cast<T*>(GetComponent(entity, GetComponentId<T>()));
+	}
+
+	template <typename T>
+	bool HasComponent(Entity entity) const {
+		return GetComponent(entity, GetComponentId<T>()) != nullptr;
+	}
+
+	/* Type erased versions, component is move constructed from and left for the caller to destroy */
+	void* AddComponent(Entity entity, ComponentId id, void* component);
+
+	void RemoveComponent(Entity entity, ComponentId id);
+
+	void* GetComponent(Entity entity, ComponentId id) const;
+
+	/* func(uint32_t count, const Entity* entities, Ts*... components) for every chunk that has all of Ts */
+	template <typename... Ts, typename Func>
+	void ForEachChunk(Func&& func) {
+		static_assert(sizeof...(Ts) > 0, "A query needs at least one component");
+		ComponentMask required = MakeComponentMask<Ts...>();
+		++_queryDepth;
+		for (auto& archetype : _archetypes) {
+			if ((archetype->GetMask() & required) != required)
+				continue;
+			for (uint32_t chunk = 0; chunk < archetype->GetChunkCount(); ++chunk) {
+				func(archetype->GetChunkEntityCount(chunk), const_cast<const Entity*>(archetype->GetChunkEntities(chunk)),
+					archetype->template GetChunkComponents<Ts>(chunk)...);
+			}
+		}
+		--_queryDepth;
+	}
+
+	/* ForEachChunk with the chunks spread over jobSystem, returns once all of them are done. func runs on several
+	   threads at once and may only write to the chunk it is handed */
+	template <typename... Ts, typename Func>
+	void ParallelForEachChunk(JobSystem& jobSystem, Func&& func) {
+		static_assert(sizeof...(Ts) > 0, "A query needs at least one component");
+		ComponentMask required = MakeComponentMask<Ts...>();
+		ST_VECTOR<std::pair<Archetype*, uint32_t>> chunks;
+		for (auto& archetype : _archetypes) {
+			if ((archetype->GetMask() & required) != required)
+				continue;
+			for (uint32_t chunk = 0; chunk < archetype->GetChunkCount(); ++chunk) {
+				chunks.emplace_back(archetype.get(), chunk);
+			}
+		}
+		++_queryDepth;
+		uint32_t chunkCount = static_cast<uint32_t>(chunks.size());
+		jobSystem.ParallelFor(chunkCount, jobSystem.GetDefaultBatchSize(chunkCount),
+			[&chunks, &func](uint32_t begin, uint32_t end) {
+				for (uint32_t i = begin; i < end; ++i) {
+					Archetype* archetype = chunks[i].first;
+					uint32_t chunk       = chunks[i].second;
+					func(archetype->GetChunkEntityCount(chunk),
+						const_cast<const Entity*>(archetype->GetChunkEntities(chunk)),
+						archetype->template GetChunkComponents<Ts>(chunk)...);
+				}
+			});
+		--_queryDepth;
+	}
+
+	/* func(Entity, Ts&... components) for every entity that has all of Ts */
+	template <typename... Ts, typename Func>
+	void ForEach(Func&& func) {
+		ForEachChunk<Ts...>([&func](uint32_t count, const Entity* entities, Ts*... components) {
+			for (uint32_t i = 0; i < count; ++i) {
+				func(entities[i], components[i]...);
+			}
+		});
+	}
+
+private:
+	struct EntityRecord {
+		Archetype* _archetype = nullptr;
+
+		uint32_t _row = 0;
+
+		uint32_t _generation = 1;
+	};
+
+	template <typename T>
+	void ConstructComponent(Archetype* archetype, uint32_t row, T&& component) {
+		using Component = typename std::decay<T>::type;
+		new(archetype->GetComponent(row, GetComponentId<Component>())) Component(std::forward<T>(component));
+	}
+
+	Archetype* GetOrCreateArchetype(ComponentMask mask);
+
+	Entity AllocateEntity(Archetype* archetype);
+
+	uint32_t AllocateIndex();
+
+	bool IsReserved(Entity entity) const;
+
+	/* Bumps the generation so copies of the handle go stale, and frees the index */
+	void FreeIndex(uint32_t index);
+
+	/* Moves the shared components over, the ones only target has are left unconstructed */
+	void MoveEntity(Entity entity, Archetype* target);
+
+	ST_VECTOR<ST_SCOPE<Archetype>> _archetypes;
+
+	ST_UNORDERED_MAP<ComponentMask, Archetype*> _archetypeByMask;
+
+	ST_VECTOR<EntityRecord> _records;
+
+	ST_VECTOR<uint32_t> _freeIndices;
+
+	uint32_t _entityCount = 0;
+
+	uint32_t _queryDepth = 0;
+};
+}
@@ -0,0 +1,167 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+#include "Profiler.h"
+
+namespace {
+thread_local const ST::JobSystem* s_queueOwner = nullptr;
+
+thread_local int s_queueIndex = -1;
+
+thread_local uint32_t s_stealSeed = 0;
+
+/* xorshift, picks the first victim so thieves do not all hammer the same deque */
+uint32_t NextStealSeed() {
+	uint32_t x = s_stealSeed ? s_stealSeed : static_cast<uint32_t>(std::hash<std::thread::id>()(
+		std::this_thread::get_id())) | 1u;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return s_stealSeed = x;
+}
+
+constexpr uint32_t IDLE_SPINS = 64;
+}
+
+ST::JobSystem::JobSystem(uint32_t workerCount) {
+	for (uint32_t i = 0; i <= workerCount; ++i) {
+		_queues.emplace_back(new JobQueue());
+	}
+	s_queueOwner = this;
+	s_queueIndex = 0;
+	for (uint32_t i = 1; i <= workerCount; ++i) {
+		_workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+	}
+}
+
+ST::JobSystem::~JobSystem() {
+	{
+		std::lock_guard<std::mutex> lock(_sleepMutex);
+		_stop = true;
+	}
+	_wakeCondition.notify_all();
+	for (auto& worker : _workers) {
+		worker.join();
+	}
+	/* nobody waits on what is left, run it so counters and captured resources are released */
+	while (Job* job = FindJob(GetThreadIndex())) {
+		Execute(job);
+	}
+	if (s_queueOwner == this) {
+		s_queueOwner = nullptr;
+		s_queueIndex = -1;
+	}
+}
+
+int ST::JobSystem::GetThreadIndex() const {
+	return s_queueOwner == this ? s_queueIndex : -1;
+}
+
+void ST::JobSystem::Run(ST_FUNC<void()> task, JobCounter* counter) {
+	if (counter)
+		counter->_count.fetch_add(1, std::memory_order_relaxed);
+	Enqueue(new Job{std::move(task), counter});
+}
+
+void ST::JobSystem::Enqueue(Job* job) {
+	_queuedJobs.fetch_add(1);
+	int queueIndex = GetThreadIndex();
+	if (queueIndex < 0 || !_queues[queueIndex]->Push(job)) {
+		std::lock_guard<std::mutex> lock(_sharedMutex);
+		_sharedJobs.push_back(job);
+	}
+	/* pairs with the check under _sleepMutex in WorkerLoop, one of the two sides sees the other */
+	if (_sleepingWorkers.load() > 0) {
+		std::lock_guard<std::mutex> lock(_sleepMutex);
+		_wakeCondition.notify_one();
+	}
+}
+
+ST::JobSystem::Job* ST::JobSystem::FindJob(int queueIndex) {
+	Job* job = nullptr;
+	if (queueIndex >= 0)
+		job = _queues[queueIndex]->Pop();
+	if (!job) {
+		std::lock_guard<std::mutex> lock(_sharedMutex);
+		if (!_sharedJobs.empty()) {
+			job = _sharedJobs.front();
+			_sharedJobs.pop_front();
+		}
+	}
+	if (!job) {
+		uint32_t queueCount = static_cast<uint32_t>(_queues.size());
+		uint32_t first      = NextStealSeed() % queueCount;
+		for (uint32_t i = 0; i < queueCount && !job; ++i) {
+			uint32_t victim = (first + i) % queueCount;
+			if (static_cast<int>(victim) != queueIndex)
+				job = _queues[victim]->Steal();
+		}
+	}
+	if (job)
+		_queuedJobs.fetch_sub(1);
+	return job;
+}
+
+void ST::JobSystem::Execute(Job* job) {
+	job->_task();
+	if (job->_counter)
+		job->_counter->_count.fetch_sub(1, std::memory_order_release);
+	delete job;
+}
+
+void ST::JobSystem::WorkerLoop(uint32_t queueIndex) {
+	s_queueOwner = this;
+	s_queueIndex = static_cast<int>(queueIndex);
+	Profiler::GetProfiler().SetThreadName("Job Worker " + std::to_string(queueIndex));
+
+	uint32_t idleSpins = 0;
+	while (!_stop.load(std::memory_order_relaxed)) {
+		if (Job* job = FindJob(s_queueIndex)) {
+			Execute(job);
+			idleSpins = 0;
+			continue;
+		}
+		if (++idleSpins < IDLE_SPINS) {
+			std::this_thread::yield();
+			continue;
+		}
+		idleSpins = 0;
+		std::unique_lock<std::mutex> lock(_sleepMutex);
+		_sleepingWorkers.fetch_add(1);
+		_wakeCondition.wait(lock, [this] { return _stop.load() || _queuedJobs.load() > 0; });
+		_sleepingWorkers.fetch_sub(1);
+	}
+}
+
+void ST::JobSystem::Wait(JobCounter& counter) {
+	int queueIndex = GetThreadIndex();
+	while (!counter.IsDone()) {
+		if (Job* job = FindJob(queueIndex))
+			Execute(job);
+		else
+			std::this_thread::yield();
+	}
+}
+
+void ST::JobSystem::ParallelFor(uint32_t count, uint32_t batchSize, const ST_FUNC<void(uint32_t, uint32_t)>& func) {
+	batchSize = std::max(batchSize, 1u);
+	if (count <= batchSize) {
+		if (count > 0)
+			func(0, count);
+		return;
+	}
+	JobCounter counter;
+	/* the caller keeps the first range for itself */
+	for (uint32_t begin = batchSize; begin < count; begin += batchSize) {
+		uint32_t end = std::min(begin + batchSize, count);
+		Run([&func, begin, end] { func(begin, end); }, &counter);
+	}
+	func(0, batchSize);
+	Wait(counter);
+}
+
+uint32_t ST::JobSystem::GetDefaultBatchSize(uint32_t count) const {
+	uint32_t rangeCount = GetThreadCount() * 4;
+	return std::max((count + rangeCount - 1) / rangeCount, 1u);
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "Core.h"
+
+namespace ST {
+/* Number of unfinished jobs tied to it, JobSystem::Wait blocks until it drops to zero */
+class JobCounter {
+public:
+	JobCounter() = default;
+
+	JobCounter(const JobCounter&) = delete;
+
+	JobCounter& operator=(const JobCounter&) = delete;
+
+	inline bool IsDone() const {
+		return _count.load(std::memory_order_acquire) == 0;
+	}
+
+private:
+	friend class JobSystem;
+
+	std::atomic<uint32_t> _count{0};
+};
+
+/*
+ * Chase-Lev deque of one thread. The owner pushes and pops at the bottom, thieves take from the top, so
+ * the owner works on its newest job while old, usually larger, jobs get stolen. Fixed capacity, Push fails
+ * when full.
+ */
+template <typename T>
+class WorkStealingQueue {
+public:
+	static constexpr int64_t CAPACITY = 4096;
+
+	static_assert((CAPACITY & (CAPACITY - 1)) == 0, "Capacity must be a power of two");
+
+	/* Owner only */
+	bool Push(T* item) {
+		int64_t bottom = _bottom.load(std::memory_order_relaxed);
+		int64_t top    = _top.load(std::memory_order_acquire);
+		if (bottom - top >= CAPACITY)
+			return false;
+		_items[bottom & (CAPACITY - 1)].store(item, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		_bottom.store(bottom + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+	/* Owner only, nullptr when empty */
+	T* Pop() {
+		int64_t bottom = _bottom.load(std::memory_order_relaxed) - 1;
+		_bottom.store(bottom, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t top = _top.load(std::memory_order_relaxed);
+		if (top > bottom) {
+			_bottom.store(bottom + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+		T* item = _items[bottom & (CAPACITY - 1)].load(std::memory_order_relaxed);
+		if (top == bottom) {
+			/* last item, race the thieves for it */
+			if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				item = nullptr;
+			_bottom.store(bottom + 1, std::memory_order_relaxed);
+		}
+		return item;
+	}
+
+	/* Any thread, nullptr when empty or when another thread won the item */
+	T* Steal() {
+		int64_t top = _top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t bottom = _bottom.load(std::memory_order_acquire);
+		if (top >= bottom)
+			return nullptr;
+		T* item = _items[top & (CAPACITY - 1)].load(std::memory_order_relaxed);
+		if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			return nullptr;
+		return item;
+	}
+
+private:
+	std::atomic<int64_t> _top{0};
+
+	/* keeps _bottom, written by the owner on every push and pop, off the line thieves contend on */
+	char _padding[64 - sizeof(std::atomic<int64_t>)];
+
+	std::atomic<int64_t> _bottom{0};
+
+	std::atomic<T*> _items[CAPACITY];
+};
+
+/*
+ * Work stealing job system. Every worker, and the thread that created the system, owns a deque; other threads
+ * submit through a shared queue. Idle workers steal from random victims and sleep once there is nothing left.
+ */
+class JobSystem {
+public:
+	/* workerCount threads on top of the calling thread, which joins in whenever it waits */
+	explicit JobSystem(uint32_t workerCount);
+
+	~JobSystem();
+
+	JobSystem(const JobSystem&) = delete;
+
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	/* Workers plus the creating thread */
+	inline uint32_t GetThreadCount() const {
+		return static_cast<uint32_t>(_queues.size());
+	}
+
+	/* counter, if any, is raised now and lowered when the job has finished */
+	void Run(ST_FUNC<void()> task, JobCounter* counter = nullptr);
+
+	/* Runs other jobs until counter reaches zero, jobs that wait on their own children do not block a worker */
+	void Wait(JobCounter& counter);
+
+	/* func(begin, end) over [0, count) in ranges of at most batchSize, returns when all of them are done */
+	void ParallelFor(uint32_t count, uint32_t batchSize, const ST_FUNC<void(uint32_t, uint32_t)>& func);
+
+	/* Batch size that gives every thread a few ranges to balance with */
+	uint32_t GetDefaultBatchSize(uint32_t count) const;
+
+	/* Index of the calling thread in [0, GetThreadCount()), -1 for threads the system does not own. Jobs use it
+	   to pick per-thread scratch without locking */
+	int GetThreadIndex() const;
+
+private:
+	struct Job {
+		ST_FUNC<void()> _task;
+
+		JobCounter* _counter;
+	};
+
+	using JobQueue = WorkStealingQueue<Job>;
+
+	void WorkerLoop(uint32_t queueIndex);
+
+	Job* FindJob(int queueIndex);
+
+	void Execute(Job* job);
+
+	void Enqueue(Job* job);
+
+	ST_VECTOR<ST_SCOPE<JobQueue>> _queues;
+
+	ST_VECTOR<std::thread> _workers;
+
+	std::deque<Job*> _sharedJobs;
+
+	std::mutex _sharedMutex;
+
+	/* Jobs pushed but not yet taken, sleeping workers wake when it goes up */
+	std::atomic<uint32_t> _queuedJobs{0};
+
+	std::atomic<uint32_t> _sleepingWorkers{0};
+
+	std::mutex _sleepMutex;
+
+	std::condition_variable _wakeCondition;
+
+	std::atomic<bool> _stop{false};
+};
+}
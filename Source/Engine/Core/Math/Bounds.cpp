@@ -0,0 +1,72 @@
+#include "Bounds.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "glm.hpp"
+
+ST::Bounds ST::Bounds::FromPoints(const glm::vec3* points, size_t count, size_t stride) {
+	Bounds bounds;
+	if (count == 0)
+		return bounds;
+
+	auto pointAt = [points, stride](size_t i) -> const glm::vec3& {
+		return *reinterpret_cast<const glm::vec3*>(reinterpret_cast<const char*>(points) + i * stride);
+	};
+	bounds._box._min = bounds._box._max = pointAt(0);
+	for (size_t i = 1; i < count; ++i) {
+		bounds._box._min = glm::min(bounds._box._min, pointAt(i));
+		bounds._box._max = glm::max(bounds._box._max, pointAt(i));
+	}
+
+	/* centered on the box, the radius is the farthest point rather than the half diagonal */
+	bounds._sphere._center = bounds._box.GetCenter();
+	float radius2 = 0;
+	for (size_t i = 0; i < count; ++i) {
+		glm::vec3 offset = pointAt(i) - bounds._sphere._center;
+		radius2 = std::max(radius2, glm::dot(offset, offset));
+	}
+	bounds._sphere._radius = std::sqrt(radius2);
+	return bounds;
+}
+
+ST::Bounds ST::Bounds::Merge(const Bounds& lhs, const Bounds& rhs) {
+	Bounds bounds;
+	bounds._box._min = glm::min(lhs._box._min, rhs._box._min);
+	bounds._box._max = glm::max(lhs._box._max, rhs._box._max);
+
+	glm::vec3 offset = rhs._sphere._center - lhs._sphere._center;
+	float distance = glm::length(offset);
+	if (distance + rhs._sphere._radius <= lhs._sphere._radius) {
+		bounds._sphere = lhs._sphere;
+	}
+	else if (distance + lhs._sphere._radius <= rhs._sphere._radius) {
+		bounds._sphere = rhs._sphere;
+	}
+	else {
+		float radius = (distance + lhs._sphere._radius + rhs._sphere._radius) * 0.5f;
+		bounds._sphere._center = lhs._sphere._center + offset * ((radius - lhs._sphere._radius) / distance);
+		bounds._sphere._radius = radius;
+	}
+	return bounds;
+}
+
+ST::Bounds ST::Bounds::Transformed(const glm::mat4& mat) const {
+	Bounds bounds;
+
+	/* Arvo: project the extent onto the absolute rotation-scale part */
+	glm::vec3 center = glm::vec3(mat * glm::vec4(_box.GetCenter(), 1));
+	glm::vec3 extent = _box.GetExtent();
+	glm::vec3 worldExtent(0);
+	for (int column = 0; column < 3; ++column) {
+		worldExtent += glm::abs(glm::vec3(mat[column])) * extent[column];
+	}
+	bounds._box._min = center - worldExtent;
+	bounds._box._max = center + worldExtent;
+
+	float maxScale = std::max(glm::length(glm::vec3(mat[0])),
+		std::max(glm::length(glm::vec3(mat[1])), glm::length(glm::vec3(mat[2]))));
+	bounds._sphere._center = glm::vec3(mat * glm::vec4(_sphere._center, 1));
+	bounds._sphere._radius = _sphere._radius * maxScale;
+	return bounds;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "fwd.hpp"
+#include "vec3.hpp"
+#include "mat4x4.hpp"
+
+namespace ST {
+struct AABB {
+	glm::vec3 _min = glm::vec3(0);
+
+	glm::vec3 _max = glm::vec3(0);
+
+	glm::vec3 GetCenter() const {
+		return (_min + _max) * 0.5f;
+	}
+
+	glm::vec3 GetExtent() const {
+		return (_max - _min) * 0.5f;
+	}
+};
+
+struct BoundingSphere {
+	glm::vec3 _center = glm::vec3(0);
+
+	float _radius = 0;
+};
+
+struct Bounds {
+	AABB _box;
+
+	BoundingSphere _sphere;
+
+	/* Points are read every stride bytes, so vertex arrays can be passed without copying positions out */
+	static Bounds FromPoints(const glm::vec3* points, size_t count, size_t stride = sizeof(glm::vec3));
+
+	static Bounds Merge(const Bounds& lhs, const Bounds& rhs);
+
+	/* Conservative bounds of this volume after an affine transform */
+	Bounds Transformed(const glm::mat4& mat) const;
+};
+}
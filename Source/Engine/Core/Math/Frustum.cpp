@@ -0,0 +1,96 @@
+#include "Frustum.h"
+
+#include "Bounds.h"
+#include "glm.hpp"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define ST_FRUSTUM_SSE 1
+#include <xmmintrin.h>
+#else
+#define ST_FRUSTUM_SSE 0
+#endif
+
+void ST::SphereBatch::Add(const BoundingSphere& sphere) {
+	_x.push_back(sphere._center.x);
+	_y.push_back(sphere._center.y);
+	_z.push_back(sphere._center.z);
+	_radius.push_back(sphere._radius);
+}
+
+ST::Frustum::Frustum(const glm::mat4& viewProj) {
+	/* glm is column major, row i is (m[0][i], m[1][i], m[2][i], m[3][i]) */
+	glm::vec4 rows[4];
+	for (int i = 0; i < 4; ++i) {
+		rows[i] = glm::vec4(viewProj[0][i], viewProj[1][i], viewProj[2][i], viewProj[3][i]);
+	}
+	_planes[0] = rows[3] + rows[0]; // left
+	_planes[1] = rows[3] - rows[0]; // right
+	_planes[2] = rows[3] + rows[1]; // bottom
+	_planes[3] = rows[3] - rows[1]; // top
+	_planes[4] = rows[3] + rows[2]; // near
+	_planes[5] = rows[3] - rows[2]; // far
+	for (auto& plane : _planes) {
+		plane /= glm::length(glm::vec3(plane));
+	}
+}
+
+bool ST::Frustum::IntersectsSphere(const BoundingSphere& sphere) const {
+	for (auto& plane : _planes) {
+		if (glm::dot(glm::vec3(plane), sphere._center) + plane.w < -sphere._radius)
+			return false;
+	}
+	return true;
+}
+
+bool ST::Frustum::IntersectsAABB(const AABB& box) const {
+	glm::vec3 center = box.GetCenter();
+	glm::vec3 extent = box.GetExtent();
+	for (auto& plane : _planes) {
+		glm::vec3 normal = glm::vec3(plane);
+		float radius = glm::dot(extent, glm::abs(normal));
+		if (glm::dot(normal, center) + plane.w < -radius)
+			return false;
+	}
+	return true;
+}
+
+void ST::Frustum::CullSpheres(const SphereBatch& spheres, ST_VECTOR<uint8_t>& visible) const {
+	uint32_t count = spheres.Size();
+	visible.resize(count);
+	uint32_t i = 0;
+
+#if ST_FRUSTUM_SSE
+	__m128 planeX[6], planeY[6], planeZ[6], planeW[6];
+	for (int p = 0; p < 6; ++p) {
+		planeX[p] = _mm_set1_ps(_planes[p].x);
+		planeY[p] = _mm_set1_ps(_planes[p].y);
+		planeZ[p] = _mm_set1_ps(_planes[p].z);
+		planeW[p] = _mm_set1_ps(_planes[p].w);
+	}
+	const __m128 zero = _mm_setzero_ps();
+	for (; i + 4 <= count; i += 4) {
+		__m128 x = _mm_loadu_ps(&spheres._x[i]);
+		__m128 y = _mm_loadu_ps(&spheres._y[i]);
+		__m128 z = _mm_loadu_ps(&spheres._z[i]);
+		__m128 negRadius = _mm_sub_ps(zero, _mm_loadu_ps(&spheres._radius[i]));
+		__m128 outside = zero;
+		for (int p = 0; p < 6; ++p) {
+			__m128 distance = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(planeX[p], x), _mm_mul_ps(planeY[p], y)),
+				_mm_add_ps(_mm_mul_ps(planeZ[p], z), planeW[p]));
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, negRadius));
+		}
+		int outsideMask = _mm_movemask_ps(outside);
+		for (int lane = 0; lane < 4; ++lane) {
+			visible[i + lane] = (outsideMask >> lane & 1) ? 0 : 1;
+		}
+	}
+#endif
+
+	for (; i < count; ++i) {
+		BoundingSphere sphere;
+		sphere._center = glm::vec3(spheres._x[i], spheres._y[i], spheres._z[i]);
+		sphere._radius = spheres._radius[i];
+		visible[i] = IntersectsSphere(sphere) ? 1 : 0;
+	}
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "Core.h"
+#include "vec4.hpp"
+#include "mat4x4.hpp"
+
+namespace ST {
+struct AABB;
+
+struct BoundingSphere;
+
+/* Structure of arrays so Frustum::CullSpheres can test four spheres per instruction */
+struct SphereBatch {
+	void Clear() {
+		_x.clear();
+		_y.clear();
+		_z.clear();
+		_radius.clear();
+	}
+
+	void Add(const BoundingSphere& sphere);
+
+	uint32_t Size() const {
+		return static_cast<uint32_t>(_x.size());
+	}
+
+	ST_VECTOR<float> _x;
+
+	ST_VECTOR<float> _y;
+
+	ST_VECTOR<float> _z;
+
+	ST_VECTOR<float> _radius;
+};
+
+class Frustum {
+public:
+	Frustum() = default;
+
+	/* Gribb-Hartmann plane extraction, normals point inward */
+	explicit Frustum(const glm::mat4& viewProj);
+
+	bool IntersectsSphere(const BoundingSphere& sphere) const;
+
+	bool IntersectsAABB(const AABB& box) const;
+
+	/* visible[i] is 1 when sphere i touches the frustum, resized to the batch size */
+	void CullSpheres(const SphereBatch& spheres, ST_VECTOR<uint8_t>& visible) const;
+
+private:
+	glm::vec4 _planes[6];
+};
+}
@@ -1 +1,13 @@
 #include "Transform.h"
+
+#include "gtc/quaternion.hpp"
+#include "gtx/transform.hpp"
+#include "MathLibrary.h"
+
+glm::mat4 ST::Transform::ToMatrix() const {
+	glm::mat4 modelTrans(1.0);
+	modelTrans = glm::scale(modelTrans, _scale);
+	modelTrans = glm::mat4_cast(MathLibrary::EulerToQuat(_rotator)) * modelTrans;
+	modelTrans = glm::translate(modelTrans, _pos);
+	return modelTrans;
+}
@@ -8,6 +8,9 @@ struct Transform {
 		const glm::vec3& rotator   = glm::vec3(0),
 		const glm::vec3& scale     = glm::vec3(1)): _pos(pos), _rotator(rotator), _scale(scale) {}
 	
+	/* Scale, then rotation, then the translation applied in that rotated and scaled space */
+	glm::mat4 ToMatrix() const;
+
 	glm::vec3 _pos = glm::vec3(0);
 
 	glm::vec3 _rotator = glm::vec3(0);
@@ -0,0 +1,164 @@
+#include "TransformHierarchy.h"
+
+#include <algorithm>
+#include <type_traits>
+
+constexpr uint32_t ST::TransformHierarchy::DEAD_SLOT;
+
+ST::TransformNode ST::TransformHierarchy::Create(const Transform& local, TransformNode parent) {
+	TransformNode node;
+	if (!_freeNodes.empty()) {
+		node = _freeNodes.back();
+		_freeNodes.pop_back();
+	}
+	else {
+		node = static_cast<TransformNode>(_slotOfNode.size());
+		_slotOfNode.push_back(DEAD_SLOT);
+	}
+
+	/* appending keeps the parent first, it already has a slot */
+	uint32_t slot = static_cast<uint32_t>(_nodeOfSlot.size());
+	_local.push_back(local);
+	_localMatrix.emplace_back(1.f);
+	_worldMatrix.emplace_back(1.f);
+	_parentSlot.push_back(parent == INVALID_TRANSFORM_NODE ? DEAD_SLOT : _slotOfNode[parent]);
+	_localDirty.push_back(1);
+	_worldDirty.push_back(1);
+	_changedStamp.push_back(0);
+	_nodeOfSlot.push_back(node);
+	_slotOfNode[node] = slot;
+	MarkDirty(slot);
+	return node;
+}
+
+void ST::TransformHierarchy::Destroy(TransformNode node) {
+	uint32_t slot = _slotOfNode[node];
+	if (slot == DEAD_SLOT)
+		return;
+	_nodeOfSlot[slot] = INVALID_TRANSFORM_NODE;
+	_slotOfNode[node] = DEAD_SLOT;
+	_freeNodes.push_back(node);
+	++_deadSlotCount;
+	/* children are found and detached by the rebuild */
+	_needsRebuild = true;
+}
+
+void ST::TransformHierarchy::SetParent(TransformNode node, TransformNode parent) {
+	uint32_t slot       = _slotOfNode[node];
+	uint32_t parentSlot = parent == INVALID_TRANSFORM_NODE ? DEAD_SLOT : _slotOfNode[parent];
+	if (_parentSlot[slot] == parentSlot)
+		return;
+	_parentSlot[slot] = parentSlot;
+	_worldDirty[slot] = 1;
+	MarkDirty(slot);
+	/* the new parent may sit after the node */
+	if (parentSlot != DEAD_SLOT && parentSlot > slot)
+		_needsRebuild = true;
+}
+
+ST::TransformNode ST::TransformHierarchy::GetParent(TransformNode node) const {
+	uint32_t parentSlot = _parentSlot[_slotOfNode[node]];
+	return parentSlot == DEAD_SLOT ? INVALID_TRANSFORM_NODE : _nodeOfSlot[parentSlot];
+}
+
+void ST::TransformHierarchy::SetLocal(TransformNode node, const Transform& local) {
+	uint32_t slot     = _slotOfNode[node];
+	_local[slot]      = local;
+	_localDirty[slot] = 1;
+	_worldDirty[slot] = 1;
+	MarkDirty(slot);
+}
+
+void ST::TransformHierarchy::MarkDirty(uint32_t slot) {
+	_firstDirtySlot = std::min(_firstDirtySlot, slot);
+}
+
+uint32_t ST::TransformHierarchy::Update() {
+	++_updateStamp;
+	if (_needsRebuild)
+		Rebuild();
+	if (_firstDirtySlot == DEAD_SLOT)
+		return 0;
+
+	/* parents come first, so a parent changed earlier in this pass already has its new world matrix */
+	uint32_t changedCount = 0;
+	for (uint32_t slot = _firstDirtySlot; slot < _nodeOfSlot.size(); ++slot) {
+		uint32_t parentSlot = _parentSlot[slot];
+		bool parentChanged  = parentSlot != DEAD_SLOT && _changedStamp[parentSlot] == _updateStamp;
+		if (!_worldDirty[slot] && !parentChanged)
+			continue;
+		if (_localDirty[slot]) {
+			_localMatrix[slot] = _local[slot].ToMatrix();
+			_localDirty[slot]  = 0;
+		}
+		_worldMatrix[slot] = parentSlot == DEAD_SLOT
+			? _localMatrix[slot]
+			: _worldMatrix[parentSlot] * _localMatrix[slot];
+		_worldDirty[slot]   = 0;
+		_changedStamp[slot] = _updateStamp;
+		++changedCount;
+	}
+	_firstDirtySlot = DEAD_SLOT;
+	return changedCount;
+}
+
+void ST::TransformHierarchy::Rebuild() {
+	uint32_t slotCount = static_cast<uint32_t>(_nodeOfSlot.size());
+
+	/* orphans of destroyed nodes become roots */
+	ST_VECTOR<ST_VECTOR<uint32_t>> children(slotCount);
+	ST_VECTOR<uint32_t> order;
+	order.reserve(slotCount - _deadSlotCount);
+	for (uint32_t slot = 0; slot < slotCount; ++slot) {
+		if (_nodeOfSlot[slot] == INVALID_TRANSFORM_NODE)
+			continue;
+		uint32_t parentSlot = _parentSlot[slot];
+		if (parentSlot != DEAD_SLOT && _nodeOfSlot[parentSlot] == INVALID_TRANSFORM_NODE) {
+			_parentSlot[slot] = parentSlot = DEAD_SLOT;
+			_worldDirty[slot] = 1;
+		}
+		if (parentSlot == DEAD_SLOT)
+			order.push_back(slot);
+		else
+			children[parentSlot].push_back(slot);
+	}
+	/* breadth first from the roots, order doubles as the queue */
+	for (size_t i = 0; i < order.size(); ++i) {
+		for (uint32_t child : children[order[i]]) {
+			order.push_back(child);
+		}
+	}
+	ST_ASSERT(order.size() == slotCount - _deadSlotCount, "Transform hierarchy has a cycle\n");
+
+	ST_VECTOR<uint32_t> newSlotOf(slotCount, DEAD_SLOT);
+	for (uint32_t i = 0; i < order.size(); ++i) {
+		newSlotOf[order[i]] = i;
+	}
+	auto reorder = [&order](auto& values) {
+		std::remove_reference_t<decltype(values)> sorted;
+		sorted.reserve(order.size());
+		for (uint32_t slot : order) {
+			sorted.push_back(values[slot]);
+		}
+		values.swap(sorted);
+	};
+	reorder(_local);
+	reorder(_localMatrix);
+	reorder(_worldMatrix);
+	reorder(_parentSlot);
+	reorder(_localDirty);
+	reorder(_worldDirty);
+	reorder(_changedStamp);
+	reorder(_nodeOfSlot);
+
+	_firstDirtySlot = DEAD_SLOT;
+	for (uint32_t slot = 0; slot < order.size(); ++slot) {
+		if (_parentSlot[slot] != DEAD_SLOT)
+			_parentSlot[slot] = newSlotOf[_parentSlot[slot]];
+		_slotOfNode[_nodeOfSlot[slot]] = slot;
+		if (_worldDirty[slot])
+			MarkDirty(slot);
+	}
+	_deadSlotCount = 0;
+	_needsRebuild  = false;
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Core.h"
+#include "Transform.h"
+#include "mat4x4.hpp"
+
+namespace ST {
+using TransformNode = uint32_t;
+
+constexpr TransformNode INVALID_TRANSFORM_NODE = ~0u;
+
+/*
+ * Parent linked transforms with cached local and world matrices. Nodes are kept in flat arrays ordered so a
+ * parent always comes before its children, breadth first after every rebuild, and Update walks them once from
+ * the first dirty slot. Nothing is touched for a frame in which no node changed.
+ */
+class TransformHierarchy {
+public:
+	TransformNode Create(const Transform& local, TransformNode parent = INVALID_TRANSFORM_NODE);
+
+	/* Children of a destroyed node become roots and keep their local transform */
+	void Destroy(TransformNode node);
+
+	void SetParent(TransformNode node, TransformNode parent);
+
+	TransformNode GetParent(TransformNode node) const;
+
+	inline const Transform& GetLocal(TransformNode node) const {
+		return _local[_slotOfNode[node]];
+	}
+
+	void SetLocal(TransformNode node, const Transform& local);
+
+	inline const glm::mat4& GetLocalMatrix(TransformNode node) const {
+		return _localMatrix[_slotOfNode[node]];
+	}
+
+	/* As of the last Update */
+	inline const glm::mat4& GetWorldMatrix(TransformNode node) const {
+		return _worldMatrix[_slotOfNode[node]];
+	}
+
+	/* True when the last Update recomputed the node's world matrix */
+	inline bool HasChanged(TransformNode node) const {
+		return _changedStamp[_slotOfNode[node]] == _updateStamp;
+	}
+
+	inline uint32_t GetNodeCount() const {
+		return static_cast<uint32_t>(_slotOfNode.size() - _freeNodes.size());
+	}
+
+	/* Recomputes the dirty nodes and everything below them, returns how many world matrices changed */
+	uint32_t Update();
+
+private:
+	static constexpr uint32_t DEAD_SLOT = ~0u;
+
+	void MarkDirty(uint32_t slot);
+
+	/* Breadth first reorder that also drops dead slots and detaches orphans */
+	void Rebuild();
+
+	/* Per slot, in parent before child order */
+	ST_VECTOR<Transform> _local;
+
+	ST_VECTOR<glm::mat4> _localMatrix;
+
+	ST_VECTOR<glm::mat4> _worldMatrix;
+
+	ST_VECTOR<uint32_t> _parentSlot;
+
+	/* The local matrix needs rebuilding from _local */
+	ST_VECTOR<uint8_t> _localDirty;
+
+	/* The world matrix needs recomputing even if the parent did not change */
+	ST_VECTOR<uint8_t> _worldDirty;
+
+	ST_VECTOR<uint32_t> _changedStamp;
+
+	ST_VECTOR<TransformNode> _nodeOfSlot;
+
+	/* Per node, DEAD_SLOT once destroyed */
+	ST_VECTOR<uint32_t> _slotOfNode;
+
+	ST_VECTOR<TransformNode> _freeNodes;
+
+	/* Lowest slot with _worldDirty set, everything before it is skipped by Update */
+	uint32_t _firstDirtySlot = DEAD_SLOT;
+
+	uint32_t _deadSlotCount = 0;
+
+	uint32_t _updateStamp = 1;
+
+	bool _needsRebuild = false;
+};
+}
@@ -0,0 +1,201 @@
+#include "Profiler.h"
+
+#include <chrono>
+
+namespace ST {
+namespace {
+thread_local ProfileThreadRing* t_threadRing = nullptr;
+
+void WriteJsonString(std::ofstream& stream, const char* text) {
+	stream << '"';
+	for (; *text != '\0'; ++text) {
+		if (*text == '"' || *text == '\\')
+			stream << '\\';
+		stream << *text;
+	}
+	stream << '"';
+}
+
+void WriteTraceEvent(std::ofstream& stream, bool& first, const char* name, uint64_t beginNs, uint64_t durationNs,
+	uint32_t pid, uint32_t tid) {
+	stream << (first ? "\n" : ",\n") << "{\"name\":";
+	WriteJsonString(stream, name);
+	stream << ",\"ph\":\"X\",\"ts\":" << beginNs / 1000.0 << ",\"dur\":" << durationNs / 1000.0
+		<< ",\"pid\":" << pid << ",\"tid\":" << tid << "}";
+	first = false;
+}
+}
+
+bool ProfileThreadRing::Push(const ProfileEvent& event) {
+	uint32_t head = _head.load(std::memory_order_relaxed);
+	if (head - _tail.load(std::memory_order_acquire) >= CAPACITY) {
+		_dropped.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+	_events[head % CAPACITY] = event;
+	_head.store(head + 1, std::memory_order_release);
+	return true;
+}
+
+void ProfileThreadRing::Drain(ST_VECTOR<ProfileEvent>& outEvents) {
+	uint32_t tail = _tail.load(std::memory_order_relaxed);
+	uint32_t head = _head.load(std::memory_order_acquire);
+	for (; tail != head; ++tail) {
+		outEvents.push_back(_events[tail % CAPACITY]);
+	}
+	_tail.store(tail, std::memory_order_release);
+}
+
+uint64_t Profiler::GetTimeNs() {
+	static const auto start = std::chrono::steady_clock::now();
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now() - start).count());
+}
+
+ProfileThreadRing& Profiler::GetThreadRing() {
+	if (!t_threadRing) {
+		std::lock_guard<std::mutex> lock(_ringMutex);
+		uint32_t threadId = static_cast<uint32_t>(_rings.size());
+		_rings.emplace_back(new ProfileThreadRing(threadId));
+		_rings.back()->_threadName = threadId == 0 ? "Main" : "Thread " + std::to_string(threadId);
+		t_threadRing = _rings.back().get();
+	}
+	return *t_threadRing;
+}
+
+void Profiler::SetThreadName(const ST_STRING& name) {
+	ProfileThreadRing& ring = GetThreadRing();
+	std::lock_guard<std::mutex> lock(_ringMutex);
+	ring._threadName = name;
+}
+
+void Profiler::BeginFrame() {
+	_currentFrame = FrameRecord();
+	_currentFrame._frameIndex = _frameIndex;
+	_currentFrame._beginNs    = GetTimeNs();
+}
+
+void Profiler::EndFrame() {
+	_currentFrame._endNs = GetTimeNs();
+	_currentFrame._drawCalls     = _pendingDrawCalls.exchange(0, std::memory_order_relaxed);
+	_currentFrame._uploadedBytes = _pendingUploadedBytes.exchange(0, std::memory_order_relaxed);
+	{
+		std::lock_guard<std::mutex> lock(_ringMutex);
+		for (auto& ring : _rings) {
+			ring->Drain(_currentFrame._cpuEvents);
+		}
+	}
+	{
+		std::lock_guard<std::mutex> lock(_resolvedMutex);
+		for (auto& resolved : _resolvedGpuFrames) {
+			for (auto it = _history.rbegin(); it != _history.rend(); ++it) {
+				if (it->_frameIndex == resolved._frameIndex) {
+					it->_gpuPasses   = std::move(resolved._passes);
+					it->_gpuResolved = true;
+					break;
+				}
+			}
+		}
+		_resolvedGpuFrames.clear();
+	}
+	++_frameIndex;
+	if (_paused)
+		return;
+
+	_history.push_back(std::move(_currentFrame));
+	if (_history.size() > HISTORY_FRAMES)
+		_history.pop_front();
+}
+
+void Profiler::BeginGpuFrame(uint64_t frameIndex) {
+	ST_ASSERT(!_gpuPassOpen, "GPU pass still open at the end of the frame\n");
+	/* the slot about to be reused was recorded GPU_LATENCY packets ago, its queries are done by now */
+	GpuFrame& gpuFrame = _gpuFrames[frameIndex % GPU_LATENCY];
+	ResolveGpuFrame(gpuFrame);
+	gpuFrame._frameIndex = frameIndex;
+	gpuFrame._usedCount  = 0;
+	_currentGpuFrame     = &gpuFrame;
+}
+
+void Profiler::BeginGpuPass(const char* name) {
+	ST_ASSERT(!_gpuPassOpen, "GPU pass %s opened inside another pass\n", name);
+	ST_ASSERT(_currentGpuFrame, "GPU pass %s opened before BeginGpuFrame\n", name);
+	GpuFrame& gpuFrame = *_currentGpuFrame;
+	if (gpuFrame._usedCount == gpuFrame._queries.size()) {
+		GpuQuery query{name, 0};
+		glGenQueries(1, &query._queryId);
+		gpuFrame._queries.push_back(query);
+	}
+	GpuQuery& query = gpuFrame._queries[gpuFrame._usedCount++];
+	query._name = name;
+	glBeginQuery(GL_TIME_ELAPSED, query._queryId);
+	_gpuPassOpen = true;
+}
+
+void Profiler::EndGpuPass() {
+	glEndQuery(GL_TIME_ELAPSED);
+	_gpuPassOpen = false;
+}
+
+void Profiler::ResolveGpuFrame(GpuFrame& gpuFrame) {
+	if (gpuFrame._usedCount == 0)
+		return;
+
+	ResolvedGpuFrame resolved{gpuFrame._frameIndex, {}};
+	for (uint32_t i = 0; i < gpuFrame._usedCount; ++i) {
+		GLuint64 elapsed = 0;
+		glGetQueryObjectui64v(gpuFrame._queries[i]._queryId, GL_QUERY_RESULT, &elapsed);
+		resolved._passes.push_back(GpuPassTiming{gpuFrame._queries[i]._name, elapsed});
+	}
+	std::lock_guard<std::mutex> lock(_resolvedMutex);
+	_resolvedGpuFrames.push_back(std::move(resolved));
+}
+
+bool Profiler::SaveChromeTrace(const ST_STRING& path) const {
+	std::ofstream stream(path, std::ios::trunc);
+	if (!stream.is_open()) {
+		ST_LOG("Profiler trace write failed! %s\n", path.c_str());
+		return false;
+	}
+
+	const uint32_t CPU_PID = 0, GPU_PID = 1;
+	bool first = true;
+	stream << "{\"traceEvents\":[";
+	for (auto& frame : _history) {
+		for (auto& event : frame._cpuEvents) {
+			WriteTraceEvent(stream, first, event._name, event._beginNs, event._endNs - event._beginNs, CPU_PID,
+				event._threadId);
+		}
+		/* elapsed-time queries carry no timestamps, lay the passes out back to back from the frame start */
+		uint64_t gpuTime = frame._beginNs;
+		for (auto& pass : frame._gpuPasses) {
+			WriteTraceEvent(stream, first, pass._name, gpuTime, pass._elapsedNs, GPU_PID, 0);
+			gpuTime += pass._elapsedNs;
+		}
+	}
+	{
+		std::lock_guard<std::mutex> lock(_ringMutex);
+		for (auto& ring : _rings) {
+			stream << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << CPU_PID
+				<< ",\"tid\":" << ring->_threadId << ",\"args\":{\"name\":";
+			WriteJsonString(stream, ring->_threadName.c_str());
+			stream << "}}";
+			first = false;
+		}
+	}
+	stream << (first ? "\n" : ",\n") << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << GPU_PID
+		<< ",\"args\":{\"name\":\"GPU\"}}\n]}\n";
+	stream.close();
+	return !stream.fail();
+}
+
+ProfileScope::ProfileScope(const char* name): _ring(Profiler::GetProfiler().GetThreadRing()), _name(name),
+	_beginNs(Profiler::GetTimeNs()) {
+	++_ring._depth;
+}
+
+ProfileScope::~ProfileScope() {
+	--_ring._depth;
+	_ring.Push(ProfileEvent{_name, _beginNs, Profiler::GetTimeNs(), _ring._threadId, _ring._depth});
+}
+}
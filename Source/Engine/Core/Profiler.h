@@ -0,0 +1,267 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <deque>
+#include <mutex>
+
+#include "Core.h"
+
+#define ENABLE_PROFILER
+
+namespace ST {
+/* One closed CPU scope, times are nanoseconds since the profiler started */
+struct ProfileEvent {
+	const char* _name;
+
+	uint64_t _beginNs;
+
+	uint64_t _endNs;
+
+	uint32_t _threadId;
+
+	uint32_t _depth;
+};
+
+struct GpuPassTiming {
+	const char* _name;
+
+	uint64_t _elapsedNs;
+};
+
+struct FrameRecord {
+	uint64_t _frameIndex = 0;
+
+	uint64_t _beginNs = 0;
+
+	uint64_t _endNs = 0;
+
+	ST_VECTOR<ProfileEvent> _cpuEvents;
+
+	/* filled in a few frames late, once the timer queries are available */
+	ST_VECTOR<GpuPassTiming> _gpuPasses;
+
+	bool _gpuResolved = false;
+
+	uint32_t _drawCalls = 0;
+
+	/* buffer and texture data handed to GL */
+	uint64_t _uploadedBytes = 0;
+};
+
+/*
+ * Single producer ring owned by one thread, drained by the profiler at the end of each frame. Producers
+ * never lock, an event pushed into a full ring is dropped and counted.
+ */
+class ProfileThreadRing {
+public:
+	static constexpr uint32_t CAPACITY = 4096;
+
+	explicit ProfileThreadRing(uint32_t threadId): _threadId(threadId) {}
+
+	bool Push(const ProfileEvent& event);
+
+	/* Profiler only */
+	void Drain(ST_VECTOR<ProfileEvent>& outEvents);
+
+	uint32_t _threadId;
+
+	ST_STRING _threadName;
+
+	/* open scopes on the owning thread */
+	uint32_t _depth = 0;
+
+	std::atomic<uint32_t> _dropped{0};
+
+private:
+	std::array<ProfileEvent, CAPACITY> _events;
+
+	std::atomic<uint32_t> _head{0};
+
+	std::atomic<uint32_t> _tail{0};
+};
+
+/*
+ * Frame profiler: CPU scopes from any thread plus GL_TIME_ELAPSED queries around render passes. Frames are
+ * begun and ended by the game thread. The render thread opens its own GPU frame per packet and reads the
+ * results GPU_LATENCY frames later so the queries never stall the pipeline.
+ */
+class Profiler {
+public:
+	static constexpr uint32_t HISTORY_FRAMES = 240;
+
+	static constexpr uint32_t GPU_LATENCY = 4;
+
+	static Profiler& GetProfiler() {
+		static Profiler profiler;
+
+		return profiler;
+	}
+
+	static uint64_t GetTimeNs();
+
+	void BeginFrame();
+
+	/* Drains every thread's ring into the frame record */
+	void EndFrame();
+
+	/* Index of the frame between BeginFrame and EndFrame, game thread only */
+	inline uint64_t GetFrameIndex() const {
+		return _frameIndex;
+	}
+
+	/* Render thread only, the passes that follow are filed under the game frame that built the packet */
+	void BeginGpuFrame(uint64_t frameIndex);
+
+	/* Render thread only, passes may not nest */
+	void BeginGpuPass(const char* name);
+
+	void EndGpuPass();
+
+	/* Any thread, totals land in the record of the next frame to end, one frame behind the render thread */
+	inline void CountDrawCall() {
+		_pendingDrawCalls.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	inline void CountUpload(size_t bytes) {
+		_pendingUploadedBytes.fetch_add(bytes, std::memory_order_relaxed);
+	}
+
+	/* Ring of the calling thread, registered on first use */
+	ProfileThreadRing& GetThreadRing();
+
+	void SetThreadName(const ST_STRING& name);
+
+	inline const std::deque<FrameRecord>& GetHistory() const {
+		return _history;
+	}
+
+	/* Writes the recorded history in the Chrome trace event format, viewable in chrome://tracing or Perfetto */
+	bool SaveChromeTrace(const ST_STRING& path) const;
+
+	inline bool IsPaused() const {
+		return _paused;
+	}
+
+	/* Keeps the history frozen for inspection, frames are still drained so the rings never fill up */
+	inline void SetPaused(bool paused) {
+		_paused = paused;
+	}
+
+private:
+	struct GpuQuery {
+		const char* _name;
+
+		unsigned int _queryId;
+	};
+
+	struct GpuFrame {
+		uint64_t _frameIndex = 0;
+
+		ST_VECTOR<GpuQuery> _queries;
+
+		uint32_t _usedCount = 0;
+	};
+
+	struct ResolvedGpuFrame {
+		uint64_t _frameIndex;
+
+		ST_VECTOR<GpuPassTiming> _passes;
+	};
+
+	Profiler() = default;
+
+	/* Render thread, the results wait in _resolvedGpuFrames until EndFrame files them */
+	void ResolveGpuFrame(GpuFrame& gpuFrame);
+
+	mutable std::mutex _ringMutex;
+
+	ST_VECTOR<ST_SCOPE<ProfileThreadRing>> _rings;
+
+	std::deque<FrameRecord> _history;
+
+	FrameRecord _currentFrame;
+
+	uint64_t _frameIndex = 0;
+
+	std::atomic<uint32_t> _pendingDrawCalls{0};
+
+	std::atomic<uint64_t> _pendingUploadedBytes{0};
+
+	/* render thread state */
+	std::array<GpuFrame, GPU_LATENCY> _gpuFrames;
+
+	GpuFrame* _currentGpuFrame = nullptr;
+
+	bool _gpuPassOpen = false;
+
+	std::mutex _resolvedMutex;
+
+	ST_VECTOR<ResolvedGpuFrame> _resolvedGpuFrames;
+
+	bool _paused = false;
+};
+
+class ProfileScope {
+public:
+	explicit ProfileScope(const char* name);
+
+	~ProfileScope();
+
+	ProfileScope(const ProfileScope&) = delete;
+
+	ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+	ProfileThreadRing& _ring;
+
+	const char* _name;
+
+	uint64_t _beginNs;
+};
+
+class GpuProfileScope {
+public:
+	explicit GpuProfileScope(const char* name) {
+		Profiler::GetProfiler().BeginGpuPass(name);
+	}
+
+	~GpuProfileScope() {
+		Profiler::GetProfiler().EndGpuPass();
+	}
+
+	GpuProfileScope(const GpuProfileScope&) = delete;
+
+	GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+};
+
+/* CPU scope and GPU timer query in one object, so ST_PROFILE_PASS stays a single statement */
+class PassProfileScope {
+public:
+	explicit PassProfileScope(const char* name): _cpuScope(name),
+		_gpuScope(name) {}
+
+private:
+	ProfileScope _cpuScope;
+
+	GpuProfileScope _gpuScope;
+};
+}
+
+#define ST_PROFILE_CONCAT_IMPL(a, b) a##b
+#define ST_PROFILE_CONCAT(a, b) ST_PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef ENABLE_PROFILER
+/* name must outlive the frame history, string literals only */
+#define ST_PROFILE_SCOPE(name) ::ST::ProfileScope ST_PROFILE_CONCAT(_profileScope, __LINE__)(name)
+/* CPU scope plus a GPU timer query, for render passes on the render thread */
+#define ST_PROFILE_PASS(name) ::ST::PassProfileScope ST_PROFILE_CONCAT(_profilePass, __LINE__)(name)
+#define ST_PROFILE_DRAW_CALL() ::ST::Profiler::GetProfiler().CountDrawCall()
+#define ST_PROFILE_UPLOAD(bytes) ::ST::Profiler::GetProfiler().CountUpload(bytes)
+#else
+/* still a statement, so an unbraced if around one keeps a body */
+#define ST_PROFILE_SCOPE(name) ((void)0)
+#define ST_PROFILE_PASS(name) ((void)0)
+#define ST_PROFILE_DRAW_CALL() ((void)0)
+#define ST_PROFILE_UPLOAD(bytes) ((void)(bytes))
+#endif
@@ -1,5 +1,6 @@
 #include "Buffer.h"
 
+#include "Profiler.h"
 #include "Texture2D.h"
 
 namespace ST {
@@ -10,6 +11,20 @@ VertexBuffer::VertexBuffer(const float* verts, uint32_t size, BufferMode mode):
 		glBufferData(GL_ARRAY_BUFFER, size, verts,GL_STATIC_DRAW);
 	else
 		glBufferData(GL_ARRAY_BUFFER, size, verts,GL_DYNAMIC_DRAW);
+	if (verts)
+		ST_PROFILE_UPLOAD(size);
+}
+
+void VertexBuffer::SetData(const void* data, uint32_t size) {
+	glBindBuffer(GL_ARRAY_BUFFER, _bufferId);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
+	ST_PROFILE_UPLOAD(size);
+}
+
+void VertexBuffer::Resize(uint32_t size) {
+	glBindBuffer(GL_ARRAY_BUFFER, _bufferId);
+	glBufferData(GL_ARRAY_BUFFER, size, nullptr,
+		_mode == BufferMode::STATIC_BUFFER ? GL_STATIC_DRAW : GL_DYNAMIC_DRAW);
 }
 
 // Ref<VertexBuffer> VertexBuffer::CreateVertexBuffer(const float* verts)
@@ -17,10 +32,133 @@ VertexBuffer::VertexBuffer(const float* verts, uint32_t size, BufferMode mode):
 //     return MakeRef<VertexBuffer>(verts);
 // }
 
+namespace {
+/* glad is generated for core 3.3 only, so ARB_buffer_storage is fetched by hand */
+typedef void (APIENTRYP BufferStorageProc)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+
+BufferStorageProc GetBufferStorage() {
+	static BufferStorageProc bufferStorage = [] {
+		bool supported = glfwExtensionSupported("GL_ARB_buffer_storage") || GLVersion.major > 4 ||
+			(GLVersion.major == 4 && GLVersion.minor >= 4);
+		return supported ? reinterpret_cast<BufferStorageProc>(glfwGetProcAddress("glBufferStorage")) : nullptr;
+	}();
+	return bufferStorage;
+}
+}
+
+StreamingBuffer::StreamingBuffer(uint32_t frameSize, uint32_t frameCount): _frameSize(frameSize),
+	_frameCount(frameCount), _fences(frameCount, nullptr) {
+	glGenBuffers(1, &_bufferId);
+	glBindBuffer(GL_ARRAY_BUFFER, _bufferId);
+	GLsizeiptr totalSize = static_cast<GLsizeiptr>(frameSize) * frameCount;
+	BufferStorageProc bufferStorage = GetBufferStorage();
+	if (bufferStorage) {
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		bufferStorage(GL_ARRAY_BUFFER, totalSize, nullptr, flags);
+		_persistentData = static_cast<unsigned char*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, totalSize, flags));
+	}
+	if (!_persistentData) {
+		glBufferData(GL_ARRAY_BUFFER, totalSize, nullptr, GL_STREAM_DRAW);
+	}
+}
+
+StreamingBuffer::~StreamingBuffer() {
+	for (GLsync fence : _fences) {
+		if (fence)
+			glDeleteSync(fence);
+	}
+	if (_persistentData) {
+		glBindBuffer(GL_ARRAY_BUFFER, _bufferId);
+		glUnmapBuffer(GL_ARRAY_BUFFER);
+	}
+	glDeleteBuffers(1, &_bufferId);
+}
+
+void StreamingBuffer::WaitFence(uint32_t frameIndex) {
+	GLsync& fence = _fences[frameIndex];
+	if (!fence)
+		return;
+	GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+	while (result == GL_TIMEOUT_EXPIRED) {
+		result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+	}
+	glDeleteSync(fence);
+	fence = nullptr;
+}
+
+StreamAllocation StreamingBuffer::Allocate(uint32_t size, uint32_t alignment) {
+	ST_ASSERT(size <= _frameSize, "Streaming allocation of %u bytes exceeds the frame size\n", size);
+	uint32_t frameStart = _frameIndex * _frameSize;
+	/* regions start at multiples of the frame size, so keep offsets aligned in absolute terms */
+	uint32_t offset = (frameStart + _head + alignment - 1) / alignment * alignment - frameStart;
+	if (offset + size > _frameSize) {
+		/* the oldest region is usually done by now, its own draws were only just issued */
+		AdvanceRegion();
+		frameStart = _frameIndex * _frameSize;
+		offset     = (frameStart + alignment - 1) / alignment * alignment - frameStart;
+	}
+	_head = offset + size;
+	ST_PROFILE_UPLOAD(size);
+
+	StreamAllocation allocation;
+	allocation._offset = frameStart + offset;
+	allocation._size   = size;
+	if (_persistentData) {
+		allocation._data = _persistentData + allocation._offset;
+	}
+	else {
+		/* the region is fenced, so nothing in flight reads this range */
+		glBindBuffer(GL_ARRAY_BUFFER, _bufferId);
+		allocation._data = glMapBufferRange(GL_ARRAY_BUFFER, allocation._offset, size,
+			GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+	}
+	return allocation;
+}
+
+void StreamingBuffer::Commit(const StreamAllocation& allocation) {
+	/* coherent persistent writes are visible to the GPU without any call */
+	if (_persistentData || !allocation._data)
+		return;
+	glBindBuffer(GL_ARRAY_BUFFER, _bufferId);
+	glUnmapBuffer(GL_ARRAY_BUFFER);
+}
+
+void StreamingBuffer::EndFrame() {
+	AdvanceRegion();
+}
+
+void StreamingBuffer::AdvanceRegion() {
+	_fences[_frameIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	_frameIndex = (_frameIndex + 1) % _frameCount;
+	_head       = 0;
+	WaitFence(_frameIndex);
+}
+
 IndexBuffer::IndexBuffer(const uint32_t* Indexs, uint32_t size) {
 	glGenBuffers(1, &_bufferId);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _bufferId);
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, Indexs,GL_STATIC_DRAW);
+	ST_PROFILE_UPLOAD(size);
+}
+
+UniformBuffer::UniformBuffer(uint32_t size, uint32_t binding) {
+	glGenBuffers(1, &_bufferId);
+	glBindBuffer(GL_UNIFORM_BUFFER, _bufferId);
+	glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+	glBindBufferBase(GL_UNIFORM_BUFFER, binding, _bufferId);
+}
+
+void UniformBuffer::SetData(const void* data, uint32_t size, uint32_t offset) {
+	glBindBuffer(GL_UNIFORM_BUFFER, _bufferId);
+	glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+	ST_PROFILE_UPLOAD(size);
 }
 
 FrameBuffer::FrameBuffer(unsigned int width, unsigned int height) {
@@ -38,16 +38,20 @@ struct BufferLayout {
 };
 
 struct LayoutParam {
-	LayoutParam(ShaderDataType type, ST_STRING name, bool normalized = false):
+	LayoutParam(ShaderDataType type, ST_STRING name, bool normalized = false, uint32_t divisor = 0):
 		_name(name),
 		normalized(normalized),
-		_type(type) {}
+		_type(type),
+		_divisor(divisor) {}
 
 	ST_STRING _name;
 
 	bool normalized;
 
 	ShaderDataType _type;
+
+	/* 0 advances per vertex, N advances once every N instances */
+	uint32_t _divisor;
 };
 
 enum class BufferMode {
@@ -86,11 +90,97 @@ public:
 		_bufferLayout = bufferLayer;
 	}
 
+	void SetData(const void* data, uint32_t size);
+
+	/* Reallocate the storage, attribute pointers recorded in a VertexArray stay valid */
+	void Resize(uint32_t size);
+
 	inline BufferLayout GetBufferLayout() const {
 		return _bufferLayout;
 	}
 };
 
+/* Sub-range of a StreamingBuffer, _data stays writable until the allocation is committed */
+struct StreamAllocation {
+	void* _data = nullptr;
+
+	uint32_t _offset = 0;
+
+	uint32_t _size = 0;
+};
+
+/*
+ * Ring of frameCount regions for data rewritten every frame. Allocations come from the current frame's
+ * region and EndFrame fences it, so a region is only reused once the GPU has consumed it. A frame that
+ * outgrows its region moves on to the next one early, which only waits if that region is still in flight. The storage is
+ * persistently mapped when GL 4.4 or ARB_buffer_storage is available, otherwise each allocation is mapped
+ * unsynchronized and unmapped on Commit.
+ */
+class StreamingBuffer {
+private:
+	unsigned int _bufferId;
+
+	BufferLayout _bufferLayout;
+
+	uint32_t _frameSize;
+
+	uint32_t _frameCount;
+
+	uint32_t _frameIndex = 0;
+
+	/* offset of the next allocation inside the current region */
+	uint32_t _head = 0;
+
+	unsigned char* _persistentData = nullptr;
+
+	ST_VECTOR<GLsync> _fences;
+
+	void WaitFence(uint32_t frameIndex);
+
+	/* Fences the current region and waits for the next one to be free */
+	void AdvanceRegion();
+
+public:
+	friend class VertexArray;
+
+	StreamingBuffer(uint32_t frameSize, uint32_t frameCount = 3);
+
+	~StreamingBuffer();
+
+	StreamingBuffer(const StreamingBuffer&) = delete;
+
+	StreamingBuffer& operator=(const StreamingBuffer&) = delete;
+
+	inline void Bind() {
+		glBindBuffer(GL_ARRAY_BUFFER, _bufferId);
+	}
+
+	inline void UnBind() {
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	void SetLayout(const BufferLayout& bufferLayer) {
+		_bufferLayout = bufferLayer;
+	}
+
+	inline BufferLayout GetBufferLayout() const {
+		return _bufferLayout;
+	}
+
+	inline bool IsPersistent() const {
+		return _persistentData != nullptr;
+	}
+
+	/* _offset is a multiple of alignment, pass the vertex stride to draw from it with a base vertex */
+	StreamAllocation Allocate(uint32_t size, uint32_t alignment = 16);
+
+	/* Must be called before drawing from the allocation, and before the next Allocate */
+	void Commit(const StreamAllocation& allocation);
+
+	/* Fences everything allocated this frame and moves on to the next region */
+	void EndFrame();
+};
+
 class IndexBuffer {
 private:
 	unsigned int _bufferId;
@@ -113,6 +203,28 @@ public:
 	}
 };
 
+class UniformBuffer {
+private:
+	unsigned int _bufferId;
+
+public:
+	UniformBuffer(uint32_t size, uint32_t binding);
+
+	~UniformBuffer() {
+		glDeleteBuffers(1, &_bufferId);
+	}
+
+	inline void Bind() {
+		glBindBuffer(GL_UNIFORM_BUFFER, _bufferId);
+	}
+
+	inline void UnBind() {
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	}
+
+	void SetData(const void* data, uint32_t size, uint32_t offset = 0);
+};
+
 class FrameBuffer {
 private:
 	class RenderBuffer {
@@ -1,6 +1,7 @@
 #include "CubeMap.h"
 
 #include "PathManager.h"
+#include "Profiler.h"
 #include "ResourceManager.h"
 #include "stb_image.h"
 
@@ -21,6 +22,7 @@ ST::CubeMap::CubeMap(const ST_VECTOR<ST_STRING>& imagePaths) {
 			else
 				format = GL_RGBA;
 			glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X +i, 0, format, width, height, 0, format,GL_UNSIGNED_BYTE, image);
+			ST_PROFILE_UPLOAD(static_cast<size_t>(width) * height * channel);
 			ResourceManager::GetResourceManager().UnloadImage(image);
 		}
 		else {
@@ -5,6 +5,10 @@
 #include "FontCharacter.h"
 #include "Log.h"
 #include "PathManager.h"
+#include "Texture2D.h"
+
+constexpr int ST::Font::ATLAS_WIDTH;
+constexpr int ST::Font::GLYPH_PADDING;
 
 ST::Font::Font() {}
 
@@ -19,22 +23,57 @@ void ST::Font::Init(ST_FONT_UINT width, ST_FONT_UINT height) {
 
 	FT_Set_Pixel_Sizes(face, width, height);
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-	
+
+	/* Rasterize every glyph and shelf-pack it into the atlas */
+	ST_VECTOR<ST_VECTOR<unsigned char>> bitmaps(128);
+	ST_VECTOR<glm::ivec2> offsets(128);
+	int penX = GLYPH_PADDING, penY = GLYPH_PADDING, rowHeight = 0;
 	for (ST_FONT_CHAR c = 0; c < 128; ++c) {
 		if (FT_Load_Char(face, c,FT_LOAD_RENDER)) {
 			ST_ERROR("ERROR::FREETYTPE: Failed to load Glyph\n");
 		}
-		if (_characters.find(c) == _characters.end()) {
-			_characters.emplace(c,ST_MAKE_REF<FontCharacter>(face, c));
+		auto character = ST_MAKE_REF<FontCharacter>(face, c);
+		const auto& bitmap = face->glyph->bitmap;
+		bitmaps[c].resize(bitmap.width * bitmap.rows);
+		for (unsigned int row = 0; row < bitmap.rows; ++row) {
+			memcpy(bitmaps[c].data() + row * bitmap.width, bitmap.buffer + row * bitmap.pitch, bitmap.width);
 		}
+		if (penX + character->_size.x + GLYPH_PADDING > ATLAS_WIDTH) {
+			penX = GLYPH_PADDING;
+			penY += rowHeight + GLYPH_PADDING;
+			rowHeight = 0;
+		}
+		offsets[c] = {penX, penY};
+		penX += character->_size.x + GLYPH_PADDING;
+		rowHeight = std::max(rowHeight, character->_size.y);
+		_characters.emplace(c, character);
 	}
 	FT_Done_Face(face);
 	FT_Done_FreeType(ft);
+
+	int atlasHeight = 1;
+	while (atlasHeight < penY + rowHeight + GLYPH_PADDING) {
+		atlasHeight <<= 1;
+	}
+	ST_VECTOR<unsigned char> atlas(ATLAS_WIDTH * atlasHeight, 0);
+	for (auto& it : _characters) {
+		const ST_FONT_CHAR c     = it.first;
+		auto& character          = it.second;
+		const glm::ivec2& offset = offsets[c];
+		for (int row = 0; row < character->_size.y; ++row) {
+			memcpy(atlas.data() + (offset.y + row) * ATLAS_WIDTH + offset.x,
+				bitmaps[c].data() + row * character->_size.x, character->_size.x);
+		}
+		character->_uvMin = glm::vec2(offset) / glm::vec2(ATLAS_WIDTH, atlasHeight);
+		character->_uvMax = glm::vec2(offset + character->_size) / glm::vec2(ATLAS_WIDTH, atlasHeight);
+	}
+	_atlas = ST_MAKE_REF<Texture2D>(ATLAS_WIDTH, atlasHeight, atlas.data(), true);
 }
 
 ST::ST_REF<ST::FontCharacter> ST::Font::GetFontCharacter(ST_FONT_CHAR c) {
-	if (_characters.find(c) != _characters.end()) {
-		return _characters[c];
+	auto it = _characters.find(c);
+	if (it != _characters.end()) {
+		return it->second;
 	}
 	return nullptr;
 }
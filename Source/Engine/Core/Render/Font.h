@@ -8,6 +8,8 @@
 namespace ST {
 struct FontCharacter;
 
+class Texture2D;
+
 using ST_FONT_CHAR = GLubyte;
 using ST_FONT_UINT = FT_UInt;
 
@@ -16,8 +18,14 @@ public:
 	Font();
 	void Init(ST_FONT_UINT width,ST_FONT_UINT height);
 	ST_REF<FontCharacter> GetFontCharacter(ST_FONT_CHAR c);
+	const ST_REF<Texture2D>& GetAtlas() const { return _atlas; }
+
+	static constexpr int ATLAS_WIDTH = 1024;
+
+	static constexpr int GLYPH_PADDING = 1;
 protected:
 	friend FontCharacter;
 	ST_MAP<ST_FONT_CHAR,ST_REF<FontCharacter>> _characters;
+	ST_REF<Texture2D> _atlas;
 };
 }
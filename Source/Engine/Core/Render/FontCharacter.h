@@ -1,6 +1,5 @@
 ﻿#pragma once
 #include "Font.h"
-#include "Texture2D.h"
 #include "vec2.hpp"
 
 namespace ST {
@@ -9,18 +8,20 @@ struct FontCharacter {
 		auto glyph          = face->glyph;
 		unsigned int width  = glyph->bitmap.width;
 		unsigned int height = glyph->bitmap.rows;
-		_texture            = ST_MAKE_REF<Texture2D>(width, height, glyph->bitmap.buffer);
 		_size               = {width, height};
 		_bearing            = {glyph->bitmap_left, glyph->bitmap_top};
 		_advance            = glyph->advance.x;
 	}
 
-	ST_REF<Texture2D> _texture;
-
 	glm::ivec2 _size;
 
 	glm::ivec2 _bearing;
 
 	GLuint _advance;
+
+	/* Glyph rect inside the font atlas, min is the top-left texel (first bitmap row) */
+	glm::vec2 _uvMin{};
+
+	glm::vec2 _uvMax{};
 };
 }
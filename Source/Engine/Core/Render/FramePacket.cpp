@@ -0,0 +1,37 @@
+#include "FramePacket.h"
+
+ST::ImguiDrawSnapshot::~ImguiDrawSnapshot() {
+	Clear();
+}
+
+void ST::ImguiDrawSnapshot::Capture(const ImDrawData* drawData) {
+	Clear();
+	if (!drawData || !drawData->Valid)
+		return;
+	for (int i = 0; i < drawData->CmdListsCount; ++i) {
+		_drawLists.push_back(drawData->CmdLists[i]->CloneOutput());
+	}
+	_drawData.Valid            = true;
+	_drawData.CmdListsCount    = static_cast<int>(_drawLists.size());
+	_drawData.TotalIdxCount    = drawData->TotalIdxCount;
+	_drawData.TotalVtxCount    = drawData->TotalVtxCount;
+	_drawData.CmdLists         = _drawLists.data();
+	_drawData.DisplayPos       = drawData->DisplayPos;
+	_drawData.DisplaySize      = drawData->DisplaySize;
+	_drawData.FramebufferScale = drawData->FramebufferScale;
+}
+
+void ST::ImguiDrawSnapshot::Clear() {
+	for (ImDrawList* drawList : _drawLists) {
+		IM_DELETE(drawList);
+	}
+	_drawLists.clear();
+	_drawData.Clear();
+}
+
+void ST::FramePacket::Clear() {
+	_sceneItems.clear();
+	_selectedItems.clear();
+	_uiDrawList.Clear();
+	_imgui.Clear();
+}
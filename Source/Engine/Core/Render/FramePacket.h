@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Core.h"
+#include "imgui.h"
+#include "Renderer3D.h"
+#include "UI/UIDrawList.h"
+
+namespace ST {
+/* Deep copy of ImGui's draw data, so the render thread can draw it while the next frame's widgets are built */
+class ImguiDrawSnapshot {
+public:
+	ImguiDrawSnapshot() = default;
+
+	~ImguiDrawSnapshot();
+
+	ImguiDrawSnapshot(const ImguiDrawSnapshot&) = delete;
+
+	ImguiDrawSnapshot& operator=(const ImguiDrawSnapshot&) = delete;
+
+	/* Clones the command, index and vertex buffers of every list in drawData */
+	void Capture(const ImDrawData* drawData);
+
+	void Clear();
+
+	inline bool IsEmpty() const {
+		return _drawLists.empty();
+	}
+
+	/* ImGui's renderer backends take a mutable pointer but only read through it */
+	inline ImDrawData* GetDrawData() const {
+		return &_drawData;
+	}
+
+private:
+	mutable ImDrawData _drawData;
+
+	ST_VECTOR<ImDrawList*> _drawLists;
+};
+
+/*
+ * Everything the render thread needs for one frame. The game thread fills it between
+ * RenderThread::BeginPacket and SubmitPacket, after that it is read only until the render thread is done.
+ */
+struct FramePacket {
+	void Clear();
+
+	/* Profiler frame the packet was built in, GPU timings are filed under it */
+	uint64_t _frameIndex = 0;
+
+	/* framebuffer size, for the viewport */
+	int _width = 0;
+
+	int _height = 0;
+
+	/* in window coordinates, the UI is laid out in them */
+	double _windowXSize = 1;
+
+	double _windowYSize = 1;
+
+	CameraBlock _camera;
+
+	/* distance to the far plane, opaque batches are depth sorted against it */
+	float _cameraFar = 1.f;
+
+	LightBlock _light;
+
+	/* visible scene meshes sorted by key, the selected entity is left out of it */
+	ST_VECTOR<DrawItem> _sceneItems;
+
+	/* meshes of the selected entity, drawn into the outline stencil */
+	ST_VECTOR<DrawItem> _selectedItems;
+
+	UIDrawList _uiDrawList;
+
+	ImguiDrawSnapshot _imgui;
+};
+}
@@ -3,20 +3,43 @@
 #include "ResourceManager.h"
 #include "Texture2D.h"
 
+uint32_t ST::Material::NextMaterialId() {
+	static uint32_t materialCount = 0;
+	return ++materialCount;
+}
+
+void ST::Material::SetTexPath(int idx, const ST_STRING& path) {
+	switch (idx) {
+		case 1: _ambientTexPath = path;
+			break;
+		case 2: _diffuseTexPath = path;
+			break;
+		case 3: _specularTexPath = path;
+			break;
+	}
+	if (idx >= 1 && idx <= 3)
+		_textures[idx - 1] = TextureHandle();
+}
+
+ST::Texture2D* ST::Material::GetTexture(int idx) {
+	auto& resourceManager = ResourceManager::GetResourceManager();
+	TextureHandle& handle = _textures[idx - 1];
+	Texture2D* texture    = resourceManager.GetTexture(handle);
+	if (!texture) {
+		handle  = resourceManager.LoadTextureHandle(GetTexPath(idx));
+		texture = resourceManager.GetTexture(handle);
+	}
+	return texture;
+}
+
 void ST::Material::Bind() {
-	ST_REF<Texture2D> _ambientTex  = ResourceManager::GetResourceManager().LoadTexture(_ambientTexPath);
-	ST_REF<Texture2D> _diffuseTex  = ResourceManager::GetResourceManager().LoadTexture(_diffuseTexPath);
-	ST_REF<Texture2D> _specularTex = ResourceManager::GetResourceManager().LoadTexture(_specularTexPath);
-	_ambientTex->Bind(_idx * 3);
-	_diffuseTex->Bind(_idx * 3 + 1);
-	_specularTex->Bind(_idx * 3 + 2);
+	for (int i = 0; i < 3; ++i) {
+		GetTexture(i + 1)->Bind(_idx * 3 + i);
+	}
 }
 
 void ST::Material::UnBind() {
-	ST_REF<Texture2D> _ambientTex  = ResourceManager::GetResourceManager().LoadTexture(_ambientTexPath);
-	ST_REF<Texture2D> _diffuseTex  = ResourceManager::GetResourceManager().LoadTexture(_diffuseTexPath);
-	ST_REF<Texture2D> _specularTex = ResourceManager::GetResourceManager().LoadTexture(_specularTexPath);
-	_ambientTex->UnBind(_idx * 3);
-	_diffuseTex->UnBind(_idx * 3 + 1);
-	_specularTex->UnBind(_idx * 3 + 2);
+	for (int i = 0; i < 3; ++i) {
+		GetTexture(i + 1)->UnBind(_idx * 3 + i);
+	}
 }
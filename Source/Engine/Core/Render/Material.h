@@ -1,5 +1,6 @@
 #pragma once
 #include "Core.h"
+#include "Texture2D.h"
 
 namespace ST {
 #define MATERIAL_DEFAULT_TEXTURE_PATH "/Resource/White.jpg"
@@ -14,7 +15,8 @@ public:
 		float shinness = 32.f, int idx = 0): _idx(idx), _shinness(shinness),
 		_ambientTexPath(ambientTexPath), _diffuseTexPath(diffuseTexPath), _specularTexPath(specularTexPath) {};
 
-	ST_STRING& GetTexPath(int idx) {
+	/* 1 ambient, 2 diffuse, 3 specular */
+	const ST_STRING& GetTexPath(int idx) const {
 		switch (idx) {
 			case 1: return _ambientTexPath;
 			case 2: return _diffuseTexPath;
@@ -23,19 +25,32 @@ public:
 		return _ambientTexPath;
 	}
 
+	void SetTexPath(int idx, const ST_STRING& path);
+
+	/* Texture for GetTexPath(idx) through a cached handle, the path is only looked up again after it changes
+	   or the texture is unloaded */
+	Texture2D* GetTexture(int idx);
+
 	int _idx = 0;
 
+	/* Unique per instance, used to group draws sharing a material */
+	uint32_t _materialId = NextMaterialId();
+
 	float _shinness = 32.f;
 
 	void Bind();
 
 	void UnBind();
 
+private:
+	static uint32_t NextMaterialId();
+
 	ST_STRING _ambientTexPath;
 
 	ST_STRING _diffuseTexPath;
 
 	ST_STRING _specularTexPath;
 
+	TextureHandle _textures[3];
 };
 }
@@ -1,10 +1,16 @@
 #include "Mesh.h"
 
+#include <algorithm>
+
 #include "Camera.h"
 #include "Material.h"
 
-void ST::Mesh::SetUpMesh() {
-	auto vertexBuffer = ST_MAKE_REF<VertexBuffer>((float*)_verts.data(), sizeof(Vertex) * _verts.size(),
+void ST::Mesh::SetUpMesh(const Vertex* verts, uint32_t vertexCount, const unsigned int* indices,
+	uint32_t indexCount) {
+	_vertexCount = vertexCount;
+	_indexCount  = indexCount;
+	_hasIndices  = indexCount != 0;
+	auto vertexBuffer = ST_MAKE_REF<VertexBuffer>(reinterpret_cast<const float*>(verts), sizeof(Vertex) * vertexCount,
 		BufferMode::STATIC_BUFFER);
 	vertexBuffer->SetLayout({
 		{Float3, "v_Pos"},
@@ -12,7 +18,25 @@ void ST::Mesh::SetUpMesh() {
 		{Float2, "v_TexCoord"}
 	});
 	_vertexArray->AddVertexBuffer(vertexBuffer);
-	auto idxBuffer = ST_MAKE_REF<IndexBuffer>(_indices.data(), sizeof(unsigned int) * _indices.size());
+	auto idxBuffer = ST_MAKE_REF<IndexBuffer>(indices, sizeof(unsigned int) * indexCount);
 	_vertexArray->SetIndexBuffer(idxBuffer);
 }
 
+void ST::Mesh::SetInstanceModels(const glm::mat4* models, uint32_t count) {
+	if (!_instanceBuffer) {
+		_instanceCapacity = std::max(count, 16u);
+		_instanceBuffer   = ST_MAKE_REF<VertexBuffer>(nullptr, sizeof(glm::mat4) * _instanceCapacity,
+			BufferMode::DYNAMIC_BUFFER);
+		_instanceBuffer->SetLayout({
+			{Mat4, "v_InstanceModel", false, 1}
+		});
+		_vertexArray->AddVertexBuffer(_instanceBuffer);
+	}
+	else if (count > _instanceCapacity) {
+		while (_instanceCapacity < count)
+			_instanceCapacity *= 2;
+		_instanceBuffer->Resize(sizeof(glm::mat4) * _instanceCapacity);
+	}
+	_instanceBuffer->SetData(models, sizeof(glm::mat4) * count);
+}
+
@@ -2,7 +2,9 @@
 #include "Core.h"
 #include "vec2.hpp"
 #include "vec3.hpp"
+#include "mat4x4.hpp"
 #include "VertexArray.h"
+#include "Math/Bounds.h"
 
 namespace ST {
 class Material;
@@ -28,12 +30,24 @@ public:
 		const ST_VECTOR<ST_REF<Material>>& materials):
 		_verts(std::forward<ST_VECTOR<Vertex>>(verts)), _indices(std::forward<ST_VECTOR<unsigned int>>(indices)),
 		_materials(materials), _vertexArray(ST_MAKE_REF<VertexArray>()) {
-		SetUpMesh();
-		if (indices.size() != 0)
-			_hasIndices = true;
+		/* an empty mesh keeps the default empty bounds, its data() may be null */
+		if (!_verts.empty())
+			_bounds = Bounds::FromPoints(&_verts.front()._pos, _verts.size(), sizeof(Vertex));
+		SetUpMesh(_verts.data(), static_cast<uint32_t>(_verts.size()),
+			_indices.data(), static_cast<uint32_t>(_indices.size()));
 	}
 
-	void SetUpMesh();
+	/* Upload straight from caller owned memory such as a mapped mesh cache, _verts and _indices stay empty */
+	Mesh(const Vertex* verts, uint32_t vertexCount, const unsigned int* indices, uint32_t indexCount,
+		const Bounds& bounds, const ST_VECTOR<ST_REF<Material>>& materials):
+		_materials(materials), _bounds(bounds), _vertexArray(ST_MAKE_REF<VertexArray>()) {
+		SetUpMesh(verts, vertexCount, indices, indexCount);
+	}
+
+	void SetUpMesh(const Vertex* verts, uint32_t vertexCount, const unsigned int* indices, uint32_t indexCount);
+
+	/* Upload per-instance model matrices read by v_InstanceModel, grows the instance buffer on demand */
+	void SetInstanceModels(const glm::mat4* models, uint32_t count);
 
 	ST_VECTOR<Vertex> _verts;
 
@@ -43,7 +57,18 @@ public:
 
 	bool _hasIndices = false;
 
+	uint32_t _vertexCount = 0;
+
+	uint32_t _indexCount = 0;
+
+	/* Object space bounds, computed from the vertices at load time or read from the mesh cache */
+	Bounds _bounds;
+
 	ST_REF<VertexArray> _vertexArray;
 
+	ST_REF<VertexBuffer> _instanceBuffer;
+
+	uint32_t _instanceCapacity = 0;
+
 };
 }
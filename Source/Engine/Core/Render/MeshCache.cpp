@@ -0,0 +1,212 @@
+#include "MeshCache.h"
+
+#include <cstdio>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "MappedFile.h"
+#include "Material.h"
+#include "Mesh.h"
+
+namespace ST {
+namespace {
+struct CacheHeader {
+	uint32_t _magic;
+
+	uint32_t _version;
+
+	uint64_t _sourceSize;
+
+	int64_t _sourceTime;
+
+	uint32_t _meshCount;
+
+	uint32_t _padding;
+};
+
+struct MeshRecord {
+	uint32_t _vertexCount;
+
+	uint32_t _indexCount;
+
+	uint32_t _materialCount;
+
+	/* box min, box max, sphere center, sphere radius */
+	float _bounds[10];
+};
+
+struct MaterialRecord {
+	float _shinness;
+
+	int32_t _idx;
+
+	uint32_t _pathLengths[3];
+};
+
+static_assert(sizeof(Vertex) == 32, "Vertex layout changed, bump MeshCache::VERSION");
+
+inline size_t Align4(size_t size) {
+	return (size + 3) & ~static_cast<size_t>(3);
+}
+
+bool GetSourceStamp(const ST_STRING& sourceFullPath, uint64_t& size, int64_t& time) {
+	struct stat fileStat;
+	if (stat(sourceFullPath.c_str(), &fileStat) != 0)
+		return false;
+	size = static_cast<uint64_t>(fileStat.st_size);
+	time = static_cast<int64_t>(fileStat.st_mtime);
+	return true;
+}
+
+/* Bounds-checked cursor over the mapped blob */
+class BlobReader {
+public:
+	BlobReader(const unsigned char* data, size_t size): _data(data), _size(size) {}
+
+	template <typename T>
+	const T* Read(size_t count = 1) {
+		size_t bytes = sizeof(T) * count;
+		if (_offset + bytes > _size)
+			return nullptr;
+		const T* ptr = reinterpret_cast<const T*>(_data + _offset);
+		_offset = Align4(_offset + bytes);
+		return ptr;
+	}
+
+private:
+	const unsigned char* _data;
+
+	size_t _size;
+
+	size_t _offset = 0;
+};
+
+void WritePadded(std::ofstream& stream, const void* data, size_t size) {
+	static const char padding[4] = {};
+	stream.write(static_cast<const char*>(data), size);
+	stream.write(padding, Align4(size) - size);
+}
+}
+
+ST_STRING MeshCache::GetCachePath(const ST_STRING& sourceFullPath) {
+	return sourceFullPath + ".stmesh";
+}
+
+bool MeshCache::Load(const ST_STRING& sourceFullPath, ST_VECTOR<ST_REF<Mesh>>& outMeshes) {
+	uint64_t sourceSize;
+	int64_t sourceTime;
+	if (!GetSourceStamp(sourceFullPath, sourceSize, sourceTime))
+		return false;
+
+	MappedFile file;
+	if (!file.Open(GetCachePath(sourceFullPath)))
+		return false;
+
+	BlobReader reader(file.GetData(), file.GetSize());
+	const CacheHeader* header = reader.Read<CacheHeader>();
+	if (!header || header->_magic != MAGIC || header->_version != VERSION ||
+		header->_sourceSize != sourceSize || header->_sourceTime != sourceTime)
+		return false;
+
+	ST_VECTOR<ST_REF<Mesh>> meshes;
+	meshes.reserve(header->_meshCount);
+	for (uint32_t i = 0; i < header->_meshCount; ++i) {
+		const MeshRecord* record = reader.Read<MeshRecord>();
+		if (!record)
+			return false;
+		const Vertex* verts         = reader.Read<Vertex>(record->_vertexCount);
+		const unsigned int* indices = reader.Read<unsigned int>(record->_indexCount);
+		if (!verts || !indices)
+			return false;
+
+		ST_VECTOR<ST_REF<Material>> materials;
+		for (uint32_t m = 0; m < record->_materialCount; ++m) {
+			const MaterialRecord* materialRecord = reader.Read<MaterialRecord>();
+			if (!materialRecord)
+				return false;
+			ST_STRING paths[3];
+			for (int p = 0; p < 3; ++p) {
+				const char* chars = reader.Read<char>(materialRecord->_pathLengths[p]);
+				if (!chars)
+					return false;
+				paths[p].assign(chars, materialRecord->_pathLengths[p]);
+			}
+			materials.emplace_back(ST_MAKE_REF<Material>(paths[0], paths[1], paths[2], materialRecord->_shinness,
+				materialRecord->_idx));
+		}
+
+		Bounds bounds;
+		bounds._box._min       = glm::vec3(record->_bounds[0], record->_bounds[1], record->_bounds[2]);
+		bounds._box._max       = glm::vec3(record->_bounds[3], record->_bounds[4], record->_bounds[5]);
+		bounds._sphere._center = glm::vec3(record->_bounds[6], record->_bounds[7], record->_bounds[8]);
+		bounds._sphere._radius = record->_bounds[9];
+		meshes.push_back(ST_MAKE_REF<Mesh>(verts, record->_vertexCount, indices, record->_indexCount, bounds,
+			materials));
+	}
+
+	outMeshes.insert(outMeshes.end(), meshes.begin(), meshes.end());
+	return true;
+}
+
+bool MeshCache::Save(const ST_STRING& sourceFullPath, const ST_VECTOR<ST_REF<Mesh>>& meshes) {
+	CacheHeader header{};
+	if (!GetSourceStamp(sourceFullPath, header._sourceSize, header._sourceTime))
+		return false;
+
+	/* written under a temporary name so a crash never leaves a truncated cache behind */
+	ST_STRING cachePath = GetCachePath(sourceFullPath);
+	ST_STRING tempPath  = cachePath + ".tmp";
+	std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+	if (!stream.is_open()) {
+		ST_LOG("Mesh cache write failed! %s\n", tempPath.c_str());
+		return false;
+	}
+
+	header._magic     = MAGIC;
+	header._version   = VERSION;
+	header._meshCount = static_cast<uint32_t>(meshes.size());
+	WritePadded(stream, &header, sizeof(header));
+
+	for (auto& mesh : meshes) {
+		MeshRecord record{};
+		record._vertexCount   = static_cast<uint32_t>(mesh->_verts.size());
+		record._indexCount    = static_cast<uint32_t>(mesh->_indices.size());
+		record._materialCount = static_cast<uint32_t>(mesh->_materials.size());
+		const Bounds& bounds  = mesh->_bounds;
+		const float boundValues[10] = {
+			bounds._box._min.x, bounds._box._min.y, bounds._box._min.z,
+			bounds._box._max.x, bounds._box._max.y, bounds._box._max.z,
+			bounds._sphere._center.x, bounds._sphere._center.y, bounds._sphere._center.z,
+			bounds._sphere._radius
+		};
+		std::copy(boundValues, boundValues + 10, record._bounds);
+		WritePadded(stream, &record, sizeof(record));
+		WritePadded(stream, mesh->_verts.data(), sizeof(Vertex) * mesh->_verts.size());
+		WritePadded(stream, mesh->_indices.data(), sizeof(unsigned int) * mesh->_indices.size());
+
+		for (auto& material : mesh->_materials) {
+			const ST_STRING* paths[3] = {
+				&material->GetTexPath(1), &material->GetTexPath(2), &material->GetTexPath(3)
+			};
+			MaterialRecord materialRecord{};
+			materialRecord._shinness = material->_shinness;
+			materialRecord._idx      = material->_idx;
+			for (int p = 0; p < 3; ++p) {
+				materialRecord._pathLengths[p] = static_cast<uint32_t>(paths[p]->size());
+			}
+			WritePadded(stream, &materialRecord, sizeof(materialRecord));
+			for (int p = 0; p < 3; ++p) {
+				WritePadded(stream, paths[p]->data(), paths[p]->size());
+			}
+		}
+	}
+
+	stream.close();
+	if (stream.fail()) {
+		std::remove(tempPath.c_str());
+		return false;
+	}
+	std::remove(cachePath.c_str());
+	return std::rename(tempPath.c_str(), cachePath.c_str()) == 0;
+}
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "Core.h"
+
+namespace ST {
+class Mesh;
+
+/*
+ * Cooked copy of an imported model stored next to the source as "<source>.stmesh". The blob holds
+ * vertex and index streams, bounds and material paths, and is tagged with the source file's size and
+ * modification time so an edited source is re-imported. Loading maps the file and uploads the streams
+ * to GL directly from the mapping.
+ */
+class MeshCache {
+public:
+	static constexpr uint32_t MAGIC   = 0x4853454D; // "MESH"
+	static constexpr uint32_t VERSION = 1;
+
+	static ST_STRING GetCachePath(const ST_STRING& sourceFullPath);
+
+	/* False if the cache is missing, stale or malformed, the caller then imports the source */
+	static bool Load(const ST_STRING& sourceFullPath, ST_VECTOR<ST_REF<Mesh>>& outMeshes);
+
+	/* Meshes must still hold their CPU side _verts and _indices */
+	static bool Save(const ST_STRING& sourceFullPath, const ST_VECTOR<ST_REF<Mesh>>& meshes);
+};
+}
@@ -2,6 +2,7 @@
 
 #include "Material.h"
 #include "Mesh.h"
+#include "MeshCache.h"
 #include "PathManager.h"
 #include "Texture2D.h"
 #include "assimp/Importer.hpp"
@@ -10,18 +11,30 @@
 
 ST::Model::Model(const ST_STRING& path) {
 	LoadModel(path);
+	ComputeBounds();
+}
+
+void ST::Model::ComputeBounds() {
+	for (size_t i = 0; i < _meshes.size(); ++i) {
+		_bounds = i == 0 ? _meshes[i]->_bounds : Bounds::Merge(_bounds, _meshes[i]->_bounds);
+	}
 }
 
 
 
 void ST::Model::LoadModel(const ST_STRING& path) {
 	_dicPath = path.substr(0, path.find_last_of("/") + 1);
+	ST_STRING fullPath = PathManager::GetFullPath(path);
+	if (MeshCache::Load(fullPath, _meshes))
+		return;
+
 	Assimp::Importer import;
-	const aiScene* scene = import.ReadFile(PathManager::GetFullPath(path), aiProcess_Triangulate | aiProcess_FlipUVs);
+	const aiScene* scene = import.ReadFile(fullPath, aiProcess_Triangulate | aiProcess_FlipUVs);
 	if (!scene || !scene->mRootNode || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE) {
 		ST_ERROR("Error assimp: %s", import.GetErrorString());
 	}
 	ProcessNode(scene->mRootNode, scene);
+	MeshCache::Save(fullPath, _meshes);
 }
 
 void ST::Model::ProcessNode(const aiNode* node, const aiScene* scene) {
@@ -36,7 +49,8 @@ void ST::Model::ProcessNode(const aiNode* node, const aiScene* scene) {
 ST::Mesh ST::Model::ProcessMesh(const aiMesh* mesh, const aiScene* scene) {
 	ST_VECTOR<Vertex> verts;
 	ST_VECTOR<unsigned int> indices;
-	ST_VECTOR<Texture2D> textures;
+	verts.reserve(mesh->mNumVertices);
+	indices.reserve(mesh->mNumFaces * 3);
 	for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
 		Vertex vertex;;
 		vertex._pos.x = mesh->mVertices[i].x;
@@ -84,13 +98,13 @@ void ST::Model::GetTextures(ST_VECTOR<ST_REF<Material>>& materials, aiMaterial*
 		aiString str;
 		aiMaterials->GetTexture(type, i, &str);
 		switch (type) {
-			case aiTextureType_AMBIENT: materials[i]->_ambientTexPath = _dicPath + str.C_Str();
+			case aiTextureType_AMBIENT: materials[i]->SetTexPath(1, _dicPath + str.C_Str());
 				break;
-			case aiTextureType_DIFFUSE: materials[i]->_diffuseTexPath = _dicPath + str.C_Str();
-				if (materials[i]->_ambientTexPath == MATERIAL_DEFAULT_TEXTURE_PATH)
-					materials[i]->_ambientTexPath = materials[i]->_diffuseTexPath;
+			case aiTextureType_DIFFUSE: materials[i]->SetTexPath(2, _dicPath + str.C_Str());
+				if (materials[i]->GetTexPath(1) == MATERIAL_DEFAULT_TEXTURE_PATH)
+					materials[i]->SetTexPath(1, materials[i]->GetTexPath(2));
 				break;
-			case aiTextureType_SPECULAR: materials[i]->_specularTexPath = _dicPath + str.C_Str();
+			case aiTextureType_SPECULAR: materials[i]->SetTexPath(3, _dicPath + str.C_Str());
 				break;
 		}
 	}
@@ -1,6 +1,7 @@
 #pragma once
 #include "Core.h"
 #include "assimp/material.h"
+#include "Math/Bounds.h"
 
 struct aiMesh;
 
@@ -21,11 +22,18 @@ class Model {
 public:
 	Model(const ST_STRING& path);
 
-	Model(const ST_VECTOR<ST_REF<Mesh>>& meshes): _meshes(meshes) {}
+	Model(const ST_VECTOR<ST_REF<Mesh>>& meshes): _meshes(meshes) {
+		ComputeBounds();
+	}
 
 	ST_VECTOR<ST_REF<Mesh>> _meshes;
 
+	/* Union of the mesh bounds in model space */
+	Bounds _bounds;
+
 private:
+	void ComputeBounds();
+
 	void LoadModel(const ST_STRING& path);
 
 	void ProcessNode(const aiNode* node, const aiScene* scene);
@@ -0,0 +1,130 @@
+#include "RenderQueue.h"
+
+#include "Material.h"
+#include "Mesh.h"
+#include "Profiler.h"
+#include "Shader.h"
+#include "Texture2D.h"
+#include "VertexArray.h"
+
+uint64_t ST::RenderQueue::MakeSortKey(RenderPass pass, uint32_t shaderId, uint32_t materialId, float depth,
+	uint32_t vertexArrayId) {
+	uint64_t depthBits = static_cast<uint64_t>(glm::clamp(depth, 0.f, 1.f) * 0xFFFF);
+	return static_cast<uint64_t>(pass) << 60 |
+		static_cast<uint64_t>(shaderId & 0xFFF) << 48 |
+		static_cast<uint64_t>(materialId & 0xFFFF) << 32 |
+		depthBits << 16 |
+		static_cast<uint64_t>(vertexArrayId & 0xFFFF);
+}
+
+void ST::RenderQueue::Submit(RenderPass pass, float depth, ST_REF<Shader> shader, ST_REF<Mesh> mesh,
+	ST_REF<Material> material, const glm::mat4* models, uint32_t count) {
+	RenderCommand command;
+	command._sortKey = MakeSortKey(pass, shader->GetShaderId(), material ? material->_materialId : 0, depth,
+		mesh->_vertexArray->GetArrayId());
+	command._shader         = shader;
+	command._mesh           = mesh;
+	command._material       = material;
+	command._instanceOffset = static_cast<uint32_t>(_instanceModels.size());
+	command._instanceCount  = count;
+	_instanceModels.insert(_instanceModels.end(), models, models + count);
+	_commands.push_back(std::move(command));
+}
+
+void ST::RenderQueue::Flush() {
+	Sort();
+	InvalidateState();
+
+	for (auto& entry : _sortEntries) {
+		auto& command = _commands[entry.second];
+		auto& mesh    = command._mesh;
+		BindProgram(*command._shader);
+		BindMaterial(*command._shader, command._material);
+		mesh->SetInstanceModels(&_instanceModels[command._instanceOffset], command._instanceCount);
+		BindVertexArray(*mesh->_vertexArray);
+
+		GLsizei instanceCount = static_cast<GLsizei>(command._instanceCount);
+		if (mesh->_indexCount > 0) {
+			glDrawElementsInstanced(GL_TRIANGLES, mesh->_indexCount,GL_UNSIGNED_INT, 0, instanceCount);
+		}
+		else {
+			glDrawArraysInstanced(GL_TRIANGLES, 0, mesh->_vertexCount, instanceCount);
+		}
+		ST_PROFILE_DRAW_CALL();
+	}
+
+	_commands.clear();
+	_instanceModels.clear();
+}
+
+void ST::RenderQueue::Sort() {
+	uint32_t count = static_cast<uint32_t>(_commands.size());
+	_sortEntries.resize(count);
+	_sortScratch.resize(count);
+	for (uint32_t i = 0; i < count; ++i) {
+		_sortEntries[i] = std::make_pair(_commands[i]._sortKey, i);
+	}
+
+	/* LSD radix sort, one byte per pass, skipping bytes every key shares */
+	for (uint32_t shift = 0; shift < 64; shift += 8) {
+		uint32_t histogram[256] = {};
+		for (auto& entry : _sortEntries) {
+			++histogram[entry.first >> shift & 0xFF];
+		}
+		if (count == 0 || histogram[_sortEntries[0].first >> shift & 0xFF] == count)
+			continue;
+
+		uint32_t offset = 0;
+		for (auto& bucket : histogram) {
+			uint32_t size = bucket;
+			bucket = offset;
+			offset += size;
+		}
+		for (auto& entry : _sortEntries) {
+			_sortScratch[histogram[entry.first >> shift & 0xFF]++] = entry;
+		}
+		_sortEntries.swap(_sortScratch);
+	}
+}
+
+void ST::RenderQueue::InvalidateState() {
+	_boundProgram     = 0;
+	_boundVertexArray = 0;
+	_boundMaterial    = nullptr;
+	_boundTextures.fill(0);
+}
+
+void ST::RenderQueue::BindProgram(const Shader& shader) {
+	if (_boundProgram == shader.GetShaderId())
+		return;
+	shader.UseShader();
+	_boundProgram = shader.GetShaderId();
+	/* material uniforms live in the program, so they must be set again */
+	_boundMaterial = nullptr;
+}
+
+void ST::RenderQueue::BindVertexArray(const VertexArray& vertexArray) {
+	if (_boundVertexArray == vertexArray.GetArrayId())
+		return;
+	vertexArray.Bind();
+	_boundVertexArray = vertexArray.GetArrayId();
+}
+
+void ST::RenderQueue::BindTexture(uint32_t slot, const Texture2D& texture) {
+	ST_ASSERT(slot < MAX_TEXTURE_SLOTS, "Texture slot out of range");
+	if (_boundTextures[slot] == texture.GetTextureId())
+		return;
+	texture.Bind(slot);
+	_boundTextures[slot] = texture.GetTextureId();
+}
+
+void ST::RenderQueue::BindMaterial(const Shader& shader, const ST_REF<Material>& material) {
+	if (!material || _boundMaterial == material.get())
+		return;
+	/* ambient, diffuse and specular occupy three consecutive slots starting at _idx * 3 */
+	for (int i = 0; i < 3; ++i) {
+		BindTexture(material->_idx * 3 + i, *material->GetTexture(i + 1));
+	}
+	shader.SetMaterial("f_Material", material);
+	_boundMaterial = material.get();
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <array>
+
+#include "Core.h"
+#include "mat4x4.hpp"
+
+namespace ST {
+class Shader;
+
+class Mesh;
+
+class Material;
+
+class Texture2D;
+
+class VertexArray;
+
+/* Passes are drawn in enum order */
+enum class RenderPass : uint8_t {
+	OPAQUE_PASS = 0,
+	TRANSPARENT_PASS
+};
+
+struct RenderCommand {
+	uint64_t _sortKey;
+
+	ST_REF<Shader> _shader;
+
+	ST_REF<Mesh> _mesh;
+
+	ST_REF<Material> _material;
+
+	uint32_t _instanceOffset;
+
+	uint32_t _instanceCount;
+};
+
+/*
+ * Collects draws for a frame, radix sorts them by key and submits them while tracking the bound
+ * program, vertex array and textures so redundant binds are skipped. Code drawing outside the queue
+ * may change GL state, so the cache is only trusted within a single Flush.
+ */
+class RenderQueue {
+public:
+	static constexpr uint32_t MAX_TEXTURE_SLOTS = 16;
+
+	/* pass:4 | shader:12 | material:16 | depth:16 | vertex array:16, depth is normalized to [0, 1] */
+	static uint64_t MakeSortKey(RenderPass pass, uint32_t shaderId, uint32_t materialId, float depth,
+		uint32_t vertexArrayId);
+
+	void Submit(RenderPass pass, float depth, ST_REF<Shader> shader, ST_REF<Mesh> mesh, ST_REF<Material> material,
+		const glm::mat4* models, uint32_t count);
+
+	void Flush();
+
+	inline uint32_t GetCommandCount() const {
+		return static_cast<uint32_t>(_commands.size());
+	}
+
+private:
+	void Sort();
+
+	void InvalidateState();
+
+	void BindProgram(const Shader& shader);
+
+	void BindVertexArray(const VertexArray& vertexArray);
+
+	void BindTexture(uint32_t slot, const Texture2D& texture);
+
+	void BindMaterial(const Shader& shader, const ST_REF<Material>& material);
+
+	ST_VECTOR<RenderCommand> _commands;
+
+	ST_VECTOR<glm::mat4> _instanceModels;
+
+	ST_VECTOR<std::pair<uint64_t, uint32_t>> _sortEntries;
+
+	ST_VECTOR<std::pair<uint64_t, uint32_t>> _sortScratch;
+
+	uint32_t _boundProgram = 0;
+
+	uint32_t _boundVertexArray = 0;
+
+	const Material* _boundMaterial = nullptr;
+
+	std::array<uint32_t, MAX_TEXTURE_SLOTS> _boundTextures{};
+};
+}
@@ -0,0 +1,61 @@
+#include "RenderThread.h"
+
+#include "Profiler.h"
+
+ST::RenderThread::RenderThread(GLFWwindow* window, RenderFunc renderFunc): _window(window),
+	_renderFunc(std::move(renderFunc)) {
+	/* a context is current on one thread at a time */
+	glfwMakeContextCurrent(nullptr);
+	_thread = std::thread(&RenderThread::RenderLoop, this);
+}
+
+ST::RenderThread::~RenderThread() {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_condition.notify_all();
+	_thread.join();
+	glfwMakeContextCurrent(_window);
+}
+
+ST::FramePacket& ST::RenderThread::BeginPacket() {
+	ST_PROFILE_SCOPE("RenderThread::BeginPacket");
+	std::unique_lock<std::mutex> lock(_mutex);
+	_condition.wait(lock, [this] { return _submittedCount - _renderedCount < PACKET_COUNT; });
+	return _packets[_submittedCount % PACKET_COUNT];
+}
+
+void ST::RenderThread::SubmitPacket() {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		++_submittedCount;
+	}
+	_condition.notify_all();
+}
+
+void ST::RenderThread::RenderLoop() {
+	glfwMakeContextCurrent(_window);
+	Profiler::GetProfiler().SetThreadName("Render");
+	while (true) {
+		uint64_t packetIndex;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_condition.wait(lock, [this] { return _stop || _renderedCount < _submittedCount; });
+			/* stopping, but packets already submitted still get drawn */
+			if (_renderedCount == _submittedCount)
+				break;
+			packetIndex = _renderedCount;
+		}
+		FramePacket& packet = _packets[packetIndex % PACKET_COUNT];
+		_renderFunc(packet);
+		/* cleared here rather than in BeginPacket, the packet may hold the last reference to a GL object */
+		packet.Clear();
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			++_renderedCount;
+		}
+		_condition.notify_all();
+	}
+	glfwMakeContextCurrent(nullptr);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "Core.h"
+#include "FramePacket.h"
+
+namespace ST {
+/*
+ * Owns the window's GL context on a thread of its own. Two frame packets take turns, the render thread draws
+ * packet N-1 while the game thread fills packet N, so simulation and GL submission overlap.
+ */
+class RenderThread {
+public:
+	static constexpr uint32_t PACKET_COUNT = 2;
+
+	using RenderFunc = ST_FUNC<void(const FramePacket&)>;
+
+	/* Takes the context away from the calling thread, renderFunc draws one packet on the render thread */
+	RenderThread(GLFWwindow* window, RenderFunc renderFunc);
+
+	/* Draws the packets already submitted, then makes the context current on the calling thread again */
+	~RenderThread();
+
+	RenderThread(const RenderThread&) = delete;
+
+	RenderThread& operator=(const RenderThread&) = delete;
+
+	/* Game thread, the empty packet to fill next. Waits while the packet that last used its slot is drawn */
+	FramePacket& BeginPacket();
+
+	/* Game thread, hands the packet from BeginPacket over without waiting for it to be drawn */
+	void SubmitPacket();
+
+private:
+	void RenderLoop();
+
+	GLFWwindow* _window;
+
+	RenderFunc _renderFunc;
+
+	std::array<FramePacket, PACKET_COUNT> _packets;
+
+	std::mutex _mutex;
+
+	std::condition_variable _condition;
+
+	/* packet i lives in _packets[i % PACKET_COUNT] */
+	uint64_t _submittedCount = 0;
+
+	uint64_t _renderedCount = 0;
+
+	bool _stop = false;
+
+	std::thread _thread;
+};
+}
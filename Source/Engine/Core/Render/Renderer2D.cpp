@@ -1,150 +1,178 @@
 #include "Renderer2D.h"
 
+#include <cstring>
 #include <GL/gl.h>
 #include "AppWindow.h"
 #include "Buffer.h"
 #include "Font.h"
 #include "FontCharacter.h"
 #include "PathManager.h"
-#include "ResourceManager.h"
+#include "Profiler.h"
 #include "VertexArray.h"
 #include "ext/matrix_clip_space.hpp"
 #include "ext/matrix_transform.hpp"
-#include "UI/Brush.h"
+
+constexpr uint32_t ST::Renderer2D::MAX_QUAD_COUNT;
+constexpr uint32_t ST::Renderer2D::MAX_TEXTURE_SLOTS;
+constexpr uint32_t ST::Renderer2D::STREAM_FRAME_COUNT;
+constexpr uint32_t ST::Renderer2D::STREAM_BATCHES_PER_FRAME;
 
 ST::Renderer2D::Renderer2D(AppWindow* appWindow):
 	_appWindow(appWindow),
 	_vertexArray(ST_MAKE_REF<VertexArray>()),
-	_textVertexArray(ST_MAKE_REF<VertexArray>()),
 	_shader(ST_MAKE_REF<Shader>("/Resource/OpenGLShader/UI_Shader.vt.glsl",
 		"/Resource/OpenGLShader/UI_Shader.fg.glsl")),
-	_texShader(ST_MAKE_REF<Shader>("/Resource/OpenGLShader/Text_Shader.vt.glsl",
-		"/Resource/OpenGLShader/Text_Shader.fg.glsl")),
 	_texture(ST_MAKE_REF<Texture2D>("/Resource/NoManSky.jpg")),
 	_font(ST_MAKE_REF<Font>()) {
-#pragma region /** Image vertex array */
-	float verts[] = {
-		// positions
-		1, 1, 1, 1,   // 右上角
-		1, -1, 1, 0,  // 右下角
-		-1, -1, 0, 0, // 左下角
-		-1, 1, 0, 1   // 左上角
-	};
-	uint32_t index[] = {
-		0, 1, 3,
-		1, 2, 3
-	};
-	auto vertexBuffer = ST_MAKE_REF<VertexBuffer>(verts, sizeof(verts), BufferMode::STATIC_BUFFER);
-	vertexBuffer->SetLayout({
+#pragma region /** Quad batch vertex array */
+	_quadStream = ST_MAKE_REF<StreamingBuffer>(sizeof(QuadVertex) * MAX_QUAD_COUNT * 4 * STREAM_BATCHES_PER_FRAME,
+		STREAM_FRAME_COUNT);
+	_quadStream->SetLayout({
 		{Float2, "v_Pos"},
-		{Float2, "v_TexCoord"}
+		{Float2, "v_TexCoord"},
+		{Float4, "v_Color"},
+		{Float1, "v_TexIndex"}
 	});
-	auto indexBuffer = ST_MAKE_REF<IndexBuffer>(index, sizeof(index));
-	_vertexArray->AddVertexBuffer(vertexBuffer);
+	ST_VECTOR<uint32_t> quadIndices(MAX_QUAD_COUNT * 6);
+	for (uint32_t i = 0, offset = 0; i < quadIndices.size(); i += 6, offset += 4) {
+		quadIndices[i + 0] = offset + 0;
+		quadIndices[i + 1] = offset + 1;
+		quadIndices[i + 2] = offset + 3;
+		quadIndices[i + 3] = offset + 1;
+		quadIndices[i + 4] = offset + 2;
+		quadIndices[i + 5] = offset + 3;
+	}
+	auto indexBuffer = ST_MAKE_REF<IndexBuffer>(quadIndices.data(), sizeof(uint32_t) * quadIndices.size());
+	_vertexArray->AddStreamingBuffer(_quadStream);
 	_vertexArray->SetIndexBuffer(indexBuffer);
-#pragma endregion
 
-#pragma region /** Text vertext array */
-	float textVerts[] = {
-		// positions
-		1, 1, 1, 0,   // 右上角
-		1, -1, 1, 1,  // 右下角
-		-1, -1, 0, 1, // 左下角
-		-1, 1, 0, 0   // 左上角
-	};
-	uint32_t textIndex[] = {
-		0, 1, 3,
-		1, 2, 3
-	};
-	vertexBuffer = ST_MAKE_REF<VertexBuffer>(textVerts, sizeof(textVerts), BufferMode::DYNAMIC_BUFFER);
-	vertexBuffer->SetLayout({
-		{Float2, "v_Pos"},
-		{Float2, "v_TexCoord"}
-	});
-	auto textIndexBuffer = ST_MAKE_REF<IndexBuffer>(textIndex, sizeof(textIndex));
-	_textVertexArray->AddVertexBuffer(vertexBuffer);
-	_textVertexArray->SetIndexBuffer(textIndexBuffer);
+	_quadVertices.reserve(MAX_QUAD_COUNT * 4);
+	_textureSlots[0] = _texture.get();
+
+	int samplers[MAX_TEXTURE_SLOTS];
+	for (uint32_t i = 0; i < MAX_TEXTURE_SLOTS; ++i) {
+		samplers[i] = i;
+	}
+	_shader->UseShader();
+	_shader->SetIntArray("f_Textures", samplers, MAX_TEXTURE_SLOTS);
 #pragma endregion
 
 	_font->Init(0, 48);
 }
 
-void ST::Renderer2D::DrawQuad(const Rect& rect, const Brush& brush) {
+void ST::Renderer2D::BeginDraw(double screenXSize, double screenYSize) {
+	_screenXSize = screenXSize;
+	_screenYSize = screenYSize;
+	StartBatch();
+}
+
+void ST::Renderer2D::EndDraw() {
+	Flush();
+	_quadStream->EndFrame();
+}
+
+void ST::Renderer2D::StartBatch() {
+	_quadVertices.clear();
+	for (uint32_t i = 1; i < _textureSlotCount; ++i) {
+		_textureSlots[i] = nullptr;
+	}
+	_textureSlotCount = 1;
+}
+
+void ST::Renderer2D::Flush() {
+	if (_quadVertices.empty()) {
+		return;
+	}
+	uint32_t size = static_cast<uint32_t>(sizeof(QuadVertex) * _quadVertices.size());
+	StreamAllocation allocation = _quadStream->Allocate(size, sizeof(QuadVertex));
+	memcpy(allocation._data, _quadVertices.data(), size);
+	_quadStream->Commit(allocation);
 	_vertexArray->Bind();
-	_vertexArray->_vertexBuffers[0]->Bind();
-	glm::mat4 transformMat = CreateTransformMat(rect);
+	for (uint32_t i = 0; i < _textureSlotCount; ++i) {
+		_textureSlots[i]->Bind(i);
+	}
 	_shader->UseShader();
-	_shader->SetVec4("f_Color", brush._color);
-	_shader->SetMat4("v_TransformMat", transformMat);
-	auto texture=ResourceManager::GetResourceManager().LoadTexture(brush._texPath);
-	if (texture == nullptr) {
-		_texture->Bind(0);
-		_shader->SetInt("f_Texture", 0);
+	glDrawElementsBaseVertex(GL_TRIANGLES, _quadVertices.size() / 4 * 6, GL_UNSIGNED_INT, 0,
+		allocation._offset / sizeof(QuadVertex));
+	ST_PROFILE_DRAW_CALL();
+	StartBatch();
+}
+
+float ST::Renderer2D::GetTextureSlot(const Texture2D* texture) {
+	for (uint32_t i = 0; i < _textureSlotCount; ++i) {
+		if (_textureSlots[i] == texture) {
+			return static_cast<float>(i);
+		}
 	}
-	else {
-		texture->Bind(1);
-		_shader->SetInt("f_Texture", 1);
+	if (_textureSlotCount == MAX_TEXTURE_SLOTS) {
+		Flush();
 	}
-	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+	_textureSlots[_textureSlotCount] = texture;
+	return static_cast<float>(_textureSlotCount++);
 }
 
-void ST::Renderer2D::DrawPoint(glm::vec2&& pos, float size, glm::vec3 color) {}
+void ST::Renderer2D::SubmitQuad(const Rect& rect, const glm::vec2 (&texCoords)[4], const glm::vec4& color,
+	const Texture2D* texture) {
+	static const glm::vec2 quadPositions[] = {{1, 1}, {1, -1}, {-1, -1}, {-1, 1}};
 
-void ST::Renderer2D::DrawSingleLineText(glm::vec2 pos, glm::vec3 color, float scale, const ST_STRING& text) {
-	_textVertexArray->Bind();
-	_textVertexArray->_vertexBuffers[0]->Bind();
+	if (_quadVertices.size() >= MAX_QUAD_COUNT * 4) {
+		Flush();
+	}
+	float texIndex = GetTextureSlot(texture);
 
-	_texShader->UseShader();
-	_texShader->SetVec3("f_Color", color);
+	glm::mat4 transformMat = CreateTransformMat(rect);
+	for (int i = 0; i < 4; ++i) {
+		_quadVertices.push_back({
+			glm::vec2(transformMat * glm::vec4(quadPositions[i], 0, 1)), texCoords[i], color, texIndex
+		});
+	}
+}
 
+void ST::Renderer2D::DrawQuad(const Rect& rect, const glm::vec4& color, const Texture2D* texture) {
+	static const glm::vec2 quadTexCoords[] = {{1, 1}, {1, 0}, {0, 0}, {0, 1}};
+
+	SubmitQuad(rect, quadTexCoords, color, texture == nullptr ? _texture.get() : texture);
+}
+
+void ST::Renderer2D::DrawPoint(glm::vec2&& pos, float size, glm::vec3 color) {}
+
+void ST::Renderer2D::DrawSingleLineText(glm::vec2 pos, glm::vec3 color, float scale, const ST_STRING& text) {
 	for (const auto& ch : text) {
 		auto fontCharacter = _font->GetFontCharacter(ch);
-		fontCharacter->_texture->Bind(3);
-		_texShader->SetInt("f_Texture", 3);
-		glm::mat4 transformMat = CreateTransformMat(Rect({
+		if (fontCharacter == nullptr) {
+			continue;
+		}
+		DrawGlyph(Rect({
 				pos.x + static_cast<float>(fontCharacter->_bearing.x) * scale,
 				pos.y + static_cast<float>(fontCharacter->_bearing.y - fontCharacter->_size.y) * scale
 			},
 			glm::vec2(static_cast<float>(fontCharacter->_size.x) * scale,
-				static_cast<float>(fontCharacter->_size.y) * scale)));
-		_texShader->SetMat4("v_TransformMat", transformMat);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+				static_cast<float>(fontCharacter->_size.y) * scale)), *fontCharacter, glm::vec4(color, 1.0f));
 		pos.x += static_cast<float>(fontCharacter->_advance >> 6) * scale;
 	}
-	_textVertexArray->UnBind();
-	/*auto fontCharacter = _font->GetFontCharacter(c);
-	fontCharacter->_texture->Bind(3);
-	fontCharacter->_size;
-	glm::mat4 transformMat = CreateTransformMat(Rect({rect._x, rect._y}, fontCharacter->_size));
-	_texShader->SetMat4("v_TransformMat", transformMat);
-
-	_texShader->SetInt("f_Texture", 3);
-	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-	_textVertexArray->UnBind();*/
 }
 
 void ST::Renderer2D::DrawSingleChar(Rect&& rect, ST_FONT_CHAR c) {
-	_textVertexArray->Bind();
-	_textVertexArray->_vertexBuffers[0]->Bind();
-
-	_texShader->UseShader();
-	_texShader->SetVec3("f_Color", glm::vec3(0.1, 0.1, 0.1));
-
 	auto fontCharacter = _font->GetFontCharacter(c);
-	fontCharacter->_texture->Bind(3);
-	fontCharacter->_size;
-	glm::mat4 transformMat = CreateTransformMat(Rect({rect._pos.x, rect._pos.y}, fontCharacter->_size));
-	_texShader->SetMat4("v_TransformMat", transformMat);
+	if (fontCharacter == nullptr) {
+		return;
+	}
+	DrawGlyph(Rect({rect._pos.x, rect._pos.y}, fontCharacter->_size), *fontCharacter, glm::vec4(0.1, 0.1, 0.1, 1));
+}
 
-	_shader->SetInt("f_Texture", 3);
-	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+void ST::Renderer2D::DrawGlyph(const Rect& rect, const FontCharacter& fontCharacter, const glm::vec4& color) {
+	// Bitmap rows are stored top-down in the atlas, so the top edge of the quad samples _uvMin.y
+	const glm::vec2 texCoords[] = {
+		{fontCharacter._uvMax.x, fontCharacter._uvMin.y},
+		{fontCharacter._uvMax.x, fontCharacter._uvMax.y},
+		{fontCharacter._uvMin.x, fontCharacter._uvMax.y},
+		{fontCharacter._uvMin.x, fontCharacter._uvMin.y}
+	};
+	SubmitQuad(rect, texCoords, color, _font->GetAtlas().get());
 }
 
 glm::mat4 ST::Renderer2D::CreateTransformMat(const Rect& rect) {
-	double screenXSize, screenYSize;
-	if (_appWindow) {
-		_appWindow->GetWindowSize(screenXSize, screenYSize);
-	}
+	const double screenXSize = _screenXSize, screenYSize = _screenYSize;
 	return glm::mat4(
 		rect._size.x / screenXSize, 0, 0, 0,
 		0, rect._size.y / screenYSize, 0, 0,
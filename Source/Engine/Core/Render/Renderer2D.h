@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+
 #include "Core.h"
 #include "Font.h"
 #include "Shader.h"
@@ -11,27 +13,58 @@ namespace ST
 {
 class Font;
 
-struct Brush;
+struct FontCharacter;
 
 class AppWindow;
+
+    /* Pre-transformed vertex appended into the quad batch, position is already in NDC */
+    struct QuadVertex
+    {
+        glm::vec2 _pos;
+        glm::vec2 _texCoord;
+        glm::vec4 _color;
+        float _texIndex;
+    };
+
     class Renderer2D
     {
     public:
         Renderer2D(AppWindow* appWindow);
-        void DrawQuad(const Rect& rect,const Brush& brush);
+        /* Screen size in pixels comes from the frame packet, the render thread may not query the window */
+        void BeginDraw(double screenXSize,double screenYSize);
+        void EndDraw();
+        void Flush();
+        /* texture nullptr draws the quad in plain color */
+        void DrawQuad(const Rect& rect,const glm::vec4& color,const Texture2D* texture);
         void DrawPoint(glm::vec2&& pos,float size,glm::vec3 color);
         void DrawFrame(const Rect& rect,glm::vec3 color);
         void DrawLine(glm::vec2 pos1,glm::vec2 pos2,float size,glm::vec3 color);
         void DrawSingleLineText(glm::vec2 pos,glm::vec3 color,float scale,const ST_STRING& text);
         void DrawSingleChar(Rect&& rect,ST_FONT_CHAR c);
+
+        static constexpr uint32_t MAX_QUAD_COUNT = 4096;
+        static constexpr uint32_t MAX_TEXTURE_SLOTS = 16;
+        /* frames the quad stream can have in flight before EndDraw waits on the GPU */
+        static constexpr uint32_t STREAM_FRAME_COUNT = 3;
+        /* full batches one frame's region holds, text plus quads or a texture slot overflow flush more than once */
+        static constexpr uint32_t STREAM_BATCHES_PER_FRAME = 4;
     private:
         glm::mat4 CreateTransformMat(const Rect& rect);
+        void StartBatch();
+        float GetTextureSlot(const Texture2D* texture);
+        void SubmitQuad(const Rect& rect,const glm::vec2 (&texCoords)[4],const glm::vec4& color,
+                        const Texture2D* texture);
+        void DrawGlyph(const Rect& rect,const FontCharacter& fontCharacter,const glm::vec4& color);
         AppWindow* _appWindow;
         ST_REF<VertexArray> _vertexArray;
-        ST_REF<VertexArray> _textVertexArray;
+        ST_REF<StreamingBuffer> _quadStream;
         ST_REF<Shader> _shader;
-        ST_REF<Shader> _texShader;
         ST_REF<Texture2D> _texture;
         ST_REF<Font> _font;
+        ST_VECTOR<QuadVertex> _quadVertices;
+        std::array<const Texture2D*, MAX_TEXTURE_SLOTS> _textureSlots{};
+        uint32_t _textureSlotCount = 1;
+        double _screenXSize = 1;
+        double _screenYSize = 1;
     };
 }
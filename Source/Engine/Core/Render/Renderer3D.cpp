@@ -1,20 +1,29 @@
 #include "Renderer3D.h"
 
+#include <algorithm>
+
+#include "AppWindow.h"
+#include "Buffer.h"
 #include "Camera.h"
 #include "CameraController.h"
 #include "CubeMap.h"
+#include "FramePacket.h"
 #include "GameObject.h"
+#include "JobSystem.h"
 #include "Mesh.h"
 #include "Model.h"
+#include "Profiler.h"
 #include "Shader.h"
 #include "Material.h"
 #include "ResourceManager.h"
 #include "VertexArray.h"
+#include "ECS/SceneComponents.h"
+#include "ECS/World.h"
+#include "Math/TransformHierarchy.h"
 #include "gtc/quaternion.hpp"
 #include "gtx/transform.hpp"
 #include "Math/MathLibrary.h"
 #include "Math/Transform.h"
-#include "UI/ImguiPanel.h"
 
 namespace ST {
 struct Vertex;
@@ -40,29 +49,41 @@ ST::Renderer3D::Renderer3D(AppWindow* window):
 		"/Resource/OpenGLShader/PureColorShader.fg.glsl");
 	shader->UseShader();
 		_frameBuffer=ST_MAKE_REF<FrameBuffer>(window->_width, _window->_height);
+	_cameraUniformBuffer = ST_MAKE_REF<UniformBuffer>(sizeof(CameraBlock), CAMERA_BLOCK_BINDING);
+	_lightUniformBuffer = ST_MAKE_REF<UniformBuffer>(sizeof(LightBlock), LIGHT_BLOCK_BINDING);
 	}
 
-void ST::Renderer3D::SetLight() {
-	_shader->SetDirLight("f_DirLight", _dirLight);
-	_shader->SetPointLight("f_PointLight", _pointLight);
-	ImguiPanel::CreateDirLightPanel("Dir Light", _dirLight);
-	ImguiPanel::CreatePointLightPanel("Point Light", _pointLight);
+void ST::Renderer3D::FillLightBlock(LightBlock& lightBlock) const {
+	lightBlock._dirLightDir = glm::vec4(_dirLight->_dir, 0);
+	lightBlock._dirLightIa = glm::vec4(_dirLight->_ia, 0);
+	lightBlock._dirLightId = glm::vec4(_dirLight->_id, 0);
+	lightBlock._dirLightIs = glm::vec4(_dirLight->_is, 0);
+	lightBlock._pointLightPos = glm::vec4(_pointLight->_pos, 1);
+	lightBlock._pointLightIa = glm::vec4(_pointLight->_ia, 0);
+	lightBlock._pointLightId = glm::vec4(_pointLight->_id, 0);
+	lightBlock._pointLightIs = _pointLight->_is;
+	lightBlock._pointLightConst = _pointLight->_const;
+	lightBlock._pointLightLinear = _pointLight->_linear;
+	lightBlock._pointLightQuadratic = _pointLight->_quadratic;
 }
 
-void ST::Renderer3D::BeginDraw(ST_REF<Shader> shader, ST_REF<Camera> camera) {
-	_shader = shader;
-	_shader->UseShader();
-	_shader->SetMat4("v_ViewProj", camera->GetViewPorjMat());
-	_shader->SetVec3("f_EyePos", camera->_transform._pos);
+void ST::Renderer3D::FillCameraBlock(const Camera& camera, CameraBlock& cameraBlock) {
+	cameraBlock._viewProj = camera.GetViewPorjMat();
+	cameraBlock._skyBoxViewProj = camera._projMat * glm::mat4(glm::mat3(camera._viewMat));
+	cameraBlock._eyePos = glm::vec4(camera._transform._pos, 1);
+}
 
+void ST::Renderer3D::BeginFrame(const FramePacket& packet) {
+	_viewProj  = packet._camera._viewProj;
+	_eyePos    = glm::vec3(packet._camera._eyePos);
+	_cameraFar = packet._cameraFar;
+	_cameraUniformBuffer->SetData(&packet._camera, sizeof(CameraBlock));
+	_lightUniformBuffer->SetData(&packet._light, sizeof(LightBlock));
 }
 
-void ST::Renderer3D::BeginDrawSkyBox(ST_REF<Shader> shader, ST_REF<Camera> camera) {
+void ST::Renderer3D::BeginDraw(ST_REF<Shader> shader) {
 	_shader = shader;
 	_shader->UseShader();
-	auto viewMat = glm::mat4(glm::mat3(camera->_viewMat));
-	_shader->SetMat4("v_ViewProj", camera->_projMat*viewMat);
-	_shader->SetVec3("f_EyePos", camera->_transform._pos);
 }
 
 void ST::Renderer3D::PostProcessRecordBegin() {
@@ -77,15 +98,8 @@ void ST::Renderer3D::BeginPostProcess() {
 	_frameBuffer->BindTexture();
 }
 
-void ST::Renderer3D::DrawModel(ST_REF<Model> model, const Transform& transform) {
-	glm::mat4 modelTrans(1.0);
-	modelTrans = scale(modelTrans, transform._scale);
-	modelTrans = mat4_cast(MathLibrary::EulerToQuat(transform._rotator)) * modelTrans;
-	modelTrans = translate(modelTrans, transform._pos);
-	_shader->SetMat4("v_Model", modelTrans);
-	for (auto& mesh : model->_meshes) {
-		DrawMesh(mesh, transform);
-	}
+glm::mat4 ST::Renderer3D::CreateModelMat(const Transform& transform) const {
+	return transform.ToMatrix();
 }
 
 void ST::Renderer3D::DrawModelByColor(ST_REF<Model> model, const Transform& transform, const glm::vec4& color) {
@@ -109,11 +123,13 @@ void ST::Renderer3D::DrawMesh(ST_REF<Mesh> mesh, const Transform& transform) {
 		_shader->SetMaterial("f_Material", material);
 	}
 
-	if (mesh->_indices.size() > 0) {
-		glDrawElements(GL_TRIANGLES, mesh->_indices.size(),GL_UNSIGNED_INT, 0);
+	if (mesh->_indexCount > 0) {
+		glDrawElements(GL_TRIANGLES, mesh->_indexCount,GL_UNSIGNED_INT, 0);
+		ST_PROFILE_DRAW_CALL();
 	}
 	else {
-		glDrawArrays(GL_TRIANGLES, 0, mesh->_verts.size());
+		glDrawArrays(GL_TRIANGLES, 0, mesh->_vertexCount);
+		ST_PROFILE_DRAW_CALL();
 	}
 }
 
@@ -123,11 +139,13 @@ void ST::Renderer3D::DrawMeshByColor(ST_REF<Mesh> mesh, const Transform& transfo
 
 	_shader->SetVec4("f_Color", color);
 
-	if (mesh->_indices.size() > 0) {
-		glDrawElements(GL_TRIANGLES, mesh->_indices.size(),GL_UNSIGNED_INT, 0);
+	if (mesh->_indexCount > 0) {
+		glDrawElements(GL_TRIANGLES, mesh->_indexCount,GL_UNSIGNED_INT, 0);
+		ST_PROFILE_DRAW_CALL();
 	}
 	else {
-		glDrawArrays(GL_TRIANGLES, 0, mesh->_verts.size());
+		glDrawArrays(GL_TRIANGLES, 0, mesh->_vertexCount);
+		ST_PROFILE_DRAW_CALL();
 	}
 }
 
@@ -137,11 +155,13 @@ void ST::Renderer3D::DrawQuad(ST_REF<Mesh> mesh) {
 	
 	_shader->SetInt("f_Texture", 0);
 
-	if (mesh->_indices.size() > 0) {
-		glDrawElements(GL_TRIANGLES, mesh->_indices.size(),GL_UNSIGNED_INT, 0);
+	if (mesh->_indexCount > 0) {
+		glDrawElements(GL_TRIANGLES, mesh->_indexCount,GL_UNSIGNED_INT, 0);
+		ST_PROFILE_DRAW_CALL();
 	}
 	else {
-		glDrawArrays(GL_TRIANGLES, 0, mesh->_verts.size());
+		glDrawArrays(GL_TRIANGLES, 0, mesh->_vertexCount);
+		ST_PROFILE_DRAW_CALL();
 	}
 }
 
@@ -157,7 +177,176 @@ void ST::Renderer3D::DrawLight(ST_REF<Mesh> mesh) {
 }
 
 void ST::Renderer3D::DrawGameObject(ST_REF<GameObject> gameObject) {
-	DrawModel(gameObject->_model, gameObject->_transform);
+	SubmitGameObject(gameObject);
+	FlushGameObjects();
+}
+
+void ST::Renderer3D::SubmitGameObject(ST_REF<GameObject> gameObject) {
+	SubmitModel(gameObject->_model, CreateModelMat(gameObject->_transform));
+}
+
+uint64_t ST::Renderer3D::MakeDrawItemKey(uint32_t materialId, uint32_t vertexArrayId, float depth) {
+	uint64_t depthBits = static_cast<uint64_t>(glm::clamp(depth, 0.f, 1.f) * 0xFFFF);
+	return static_cast<uint64_t>(materialId & 0xFFFF) << 48 |
+		static_cast<uint64_t>(vertexArrayId & 0xFFFF) << 32 |
+		depthBits << 16;
+}
+
+ST::DrawItem ST::Renderer3D::MakeDrawItem(const ST_REF<Mesh>& mesh, const glm::mat4& modelTrans,
+	const glm::vec3& eyePos, float cameraFar) {
+	uint32_t materialId = mesh->_materials.empty() ? 0 : mesh->_materials.back()->_materialId;
+	float depth         = glm::length(glm::vec3(modelTrans[3]) - eyePos) / cameraFar;
+	return DrawItem{mesh, modelTrans, depth,
+		MakeDrawItemKey(materialId, mesh->_vertexArray->GetArrayId(), depth)};
+}
+
+void ST::Renderer3D::CollectDrawItems(World& world, const TransformHierarchy& transforms, Entity selected,
+	JobSystem& jobSystem, FramePacket& packet) {
+	ST_PROFILE_SCOPE("Renderer3D::CollectDrawItems");
+	const Frustum frustum(packet._camera._viewProj);
+	const glm::vec3 eyePos(packet._camera._eyePos);
+	const float cameraFar = packet._cameraFar;
+	uint32_t threadCount  = jobSystem.GetThreadCount();
+	_threadDrawLists.resize(threadCount + 1);
+
+	world.ParallelForEachChunk<SceneNodeComponent, RenderComponent, BoundsComponent>(jobSystem, [&](uint32_t count,
+		const Entity* entities, SceneNodeComponent* nodes, RenderComponent* renders, BoundsComponent* bounds) {
+		int threadIndex = jobSystem.GetThreadIndex();
+		auto& drawList  = _threadDrawLists[threadIndex < 0 ? threadCount : threadIndex]._items;
+		for (uint32_t i = 0; i < count; ++i) {
+			if (!renders[i]._model)
+				continue;
+			const glm::mat4& modelTrans = transforms.GetWorldMatrix(nodes[i]._node);
+			if (transforms.HasChanged(nodes[i]._node))
+				bounds[i]._world = renders[i]._model->_bounds.Transformed(modelTrans);
+			/* whole models first, then the meshes of the survivors, spheres before the tighter boxes */
+			if (entities[i] == selected || !frustum.IntersectsSphere(bounds[i]._world._sphere))
+				continue;
+			for (auto& mesh : renders[i]._model->_meshes) {
+				Bounds worldBounds = mesh->_bounds.Transformed(modelTrans);
+				if (frustum.IntersectsSphere(worldBounds._sphere) && frustum.IntersectsAABB(worldBounds._box))
+					drawList.push_back(MakeDrawItem(mesh, modelTrans, eyePos, cameraFar));
+			}
+		}
+	});
+	{
+		ST_PROFILE_SCOPE("Renderer3D::SortDrawItems");
+		jobSystem.ParallelFor(threadCount + 1, 1, [this](uint32_t begin, uint32_t end) {
+			for (uint32_t i = begin; i < end; ++i) {
+				auto& items = _threadDrawLists[i]._items;
+				std::sort(items.begin(), items.end(), [](const DrawItem& lhs, const DrawItem& rhs) {
+					return lhs._sortKey < rhs._sortKey;
+				});
+			}
+		});
+		MergeThreadDrawLists(packet._sceneItems);
+	}
+
+	SceneNodeComponent* node = world.GetComponent<SceneNodeComponent>(selected);
+	RenderComponent* render  = world.GetComponent<RenderComponent>(selected);
+	if (!node || !render || !render->_model)
+		return;
+	const glm::mat4& modelTrans = transforms.GetWorldMatrix(node->_node);
+	for (auto& mesh : render->_model->_meshes) {
+		packet._selectedItems.push_back(MakeDrawItem(mesh, modelTrans, eyePos, cameraFar));
+	}
+}
+
+void ST::Renderer3D::MergeThreadDrawLists(ST_VECTOR<DrawItem>& outItems) {
+	/* min-heap of the head of every non-empty list */
+	auto greater = [](const MergeHead& lhs, const MergeHead& rhs) {
+		return lhs._sortKey > rhs._sortKey;
+	};
+	size_t totalCount = 0;
+	_mergeHeads.clear();
+	for (uint32_t i = 0; i < _threadDrawLists.size(); ++i) {
+		auto& items = _threadDrawLists[i]._items;
+		totalCount += items.size();
+		if (!items.empty())
+			_mergeHeads.push_back(MergeHead{items[0]._sortKey, i, 0});
+	}
+	outItems.reserve(outItems.size() + totalCount);
+	std::make_heap(_mergeHeads.begin(), _mergeHeads.end(), greater);
+	while (!_mergeHeads.empty()) {
+		std::pop_heap(_mergeHeads.begin(), _mergeHeads.end(), greater);
+		MergeHead& head = _mergeHeads.back();
+		auto& items     = _threadDrawLists[head._list]._items;
+		outItems.push_back(std::move(items[head._cursor]));
+		if (++head._cursor < items.size()) {
+			head._sortKey = items[head._cursor]._sortKey;
+			std::push_heap(_mergeHeads.begin(), _mergeHeads.end(), greater);
+		}
+		else
+			_mergeHeads.pop_back();
+	}
+	for (auto& drawList : _threadDrawLists) {
+		drawList._items.clear();
+	}
+}
+
+void ST::Renderer3D::SubmitDrawItems(const ST_VECTOR<DrawItem>& items) {
+	/* scene items arrive sorted by key, so the instances of a mesh are already adjacent */
+	size_t end = 0;
+	for (size_t begin = 0; begin < items.size(); begin = end) {
+		const ST_REF<Mesh>& mesh = items[begin]._mesh;
+		float depth = 1.f;
+		_runModels.clear();
+		for (end = begin; end < items.size() && items[end]._mesh == mesh; ++end) {
+			_runModels.push_back(items[end]._model);
+			depth = std::min(depth, items[end]._depth);
+		}
+		ST_REF<Material> material = mesh->_materials.empty() ? nullptr : mesh->_materials.back();
+		_renderQueue.Submit(RenderPass::OPAQUE_PASS, depth, _shader, mesh, material, _runModels.data(),
+			static_cast<uint32_t>(_runModels.size()));
+	}
+	_renderQueue.Flush();
+}
+
+void ST::Renderer3D::SubmitModel(const ST_REF<Model>& model, const glm::mat4& modelTrans) {
+	for (auto& mesh : model->_meshes) {
+		Bounds worldBounds = mesh->_bounds.Transformed(modelTrans);
+		_cullItems.push_back(CullItem{mesh, modelTrans, worldBounds._box});
+		_cullSpheres.Add(worldBounds._sphere);
+	}
+}
+
+void ST::Renderer3D::FlushGameObjects() {
+	/* spheres reject in bulk, the tighter box test only runs on the survivors */
+	Frustum frustum(_viewProj);
+	frustum.CullSpheres(_cullSpheres, _cullVisible);
+	for (size_t i = 0; i < _cullItems.size(); ++i) {
+		auto& item = _cullItems[i];
+		if (!_cullVisible[i] || !frustum.IntersectsAABB(item._worldBox))
+			continue;
+		AddToInstanceBatch(item._mesh, item._model);
+	}
+	_cullItems.clear();
+	_cullSpheres.Clear();
+	FlushInstanceBatches();
+}
+
+void ST::Renderer3D::AddToInstanceBatch(const ST_REF<Mesh>& mesh, const glm::mat4& modelTrans) {
+	ST_REF<Material> material = mesh->_materials.empty() ? nullptr : mesh->_materials.back();
+	auto& batch     = _instanceBatches[std::make_pair(mesh.get(), material.get())];
+	batch._mesh     = mesh;
+	batch._material = material;
+	batch._models.push_back(modelTrans);
+}
+
+void ST::Renderer3D::FlushInstanceBatches() {
+	for (auto& it : _instanceBatches) {
+		auto& batch = it.second;
+		/* nearest instance decides the batch depth so opaque batches go roughly front to back */
+		float depth = 1.f;
+		for (auto& model : batch._models) {
+			float distance = glm::length(glm::vec3(model[3]) - _eyePos) / _cameraFar;
+			depth = std::min(depth, distance);
+		}
+		_renderQueue.Submit(RenderPass::OPAQUE_PASS, depth, _shader, batch._mesh, batch._material,
+			batch._models.data(), static_cast<uint32_t>(batch._models.size()));
+	}
+	_instanceBatches.clear();
+	_renderQueue.Flush();
 }
 
 void ST::Renderer3D::DrawScaledGameObjectByColor(ST_REF<GameObject> gameObject, const glm::vec3& scale,
@@ -1,6 +1,10 @@
 #pragma once
 #include "Core.h"
 #include "Light.h"
+#include "RenderQueue.h"
+#include "ECS/Entity.h"
+#include "Math/Bounds.h"
+#include "Math/Frustum.h"
 
 namespace ST {
 class CubeMap;
@@ -27,11 +31,79 @@ class Shader;
 
 class GameObject;
 
+class UniformBuffer;
+
+class Material;
+
+class World;
+
+class TransformHierarchy;
+
+class JobSystem;
+
+struct FramePacket;
+
+/* std140 mirror of CameraBlock, uploaded once per frame */
+struct CameraBlock {
+	glm::mat4 _viewProj;
+
+	glm::mat4 _skyBoxViewProj;
+
+	glm::vec4 _eyePos;
+};
+
+static_assert(sizeof(CameraBlock) == 144, "CameraBlock must match the std140 layout");
+
+/* std140 mirror of LightBlock, vec3 members are padded to 16 bytes except where a scalar follows */
+struct LightBlock {
+	glm::vec4 _dirLightDir;
+
+	glm::vec4 _dirLightIa;
+
+	glm::vec4 _dirLightId;
+
+	glm::vec4 _dirLightIs;
+
+	glm::vec4 _pointLightPos;
+
+	glm::vec4 _pointLightIa;
+
+	glm::vec4 _pointLightId;
+
+	glm::vec3 _pointLightIs;
+
+	float _pointLightConst;
+
+	float _pointLightLinear;
+
+	float _pointLightQuadratic;
+
+	float _padding[2];
+};
+
+static_assert(sizeof(LightBlock) == 144, "LightBlock must match the std140 layout");
+
+/* One mesh instance that survived culling, the game thread hands these to the render thread */
+struct DrawItem {
+	ST_REF<Mesh> _mesh;
+
+	glm::mat4 _model;
+
+	/* distance to the eye over the far plane distance */
+	float _depth;
+
+	/* Renderer3D::MakeDrawItemKey */
+	uint64_t _sortKey;
+};
+
 class Renderer3D {
 public:
 	Renderer3D(AppWindow* window);
 
-	void SetLight();
+	/* Game thread, the light panels edit _dirLight and _pointLight between frames */
+	void FillLightBlock(LightBlock& lightBlock) const;
+
+	static void FillCameraBlock(const Camera& camera, CameraBlock& cameraBlock);
 
 	void PostProcessRecordBegin();
 
@@ -39,14 +111,35 @@ public:
 
 	void BeginPostProcess();
 
-	void BeginDraw(ST_REF<Shader> shader, ST_REF<Camera> camera);
-	
-	void BeginDrawSkyBox(ST_REF<Shader> shader, ST_REF<Camera> camera);
+	/* Upload the packet's camera and light blocks shared by every 3D shader, call once per frame on the render
+	   thread before any BeginDraw */
+	void BeginFrame(const FramePacket& packet);
+
+	void BeginDraw(ST_REF<Shader> shader);
 
 	void DrawLight(ST_REF<Mesh> mesh);
 	
 	void DrawGameObject(ST_REF<GameObject> gameObject);
 
+	/* Queue a game object, meshes sharing a material become one instanced command in the render queue */
+	void SubmitGameObject(ST_REF<GameObject> gameObject);
+
+	void FlushGameObjects();
+
+	/* Game thread, fills the packet's scene items with the meshes of every entity with SceneNodeComponent,
+	   RenderComponent and BoundsComponent that survive its frustum, and its selected items with the meshes of
+	   selected. Chunks are culled in parallel into per-thread lists, which are sorted and merged by key.
+	   Call after transforms.Update(), only moved entities get their bounds refreshed */
+	void CollectDrawItems(World& world, const TransformHierarchy& transforms, Entity selected,
+		JobSystem& jobSystem, FramePacket& packet);
+
+	/* material:16 | vertex array:16 | depth:16, instances of a mesh and material sort next to each other,
+	   nearest first. depth is normalized to [0, 1] */
+	static uint64_t MakeDrawItemKey(uint32_t materialId, uint32_t vertexArrayId, float depth);
+
+	/* Render thread, every run of items sharing a mesh becomes one instanced command in the render queue */
+	void SubmitDrawItems(const ST_VECTOR<DrawItem>& items);
+
 	void DrawScaledGameObjectByColor(ST_REF<GameObject> gameObject, const glm::vec3& scale, const glm::vec4& color);
 
 	void DrawQuad(ST_REF<Mesh> mesh);
@@ -61,7 +154,54 @@ public:
 			1.0f, 0.045f, 0.0075f);
 
 private:
-	void DrawModel(ST_REF<Model> model, const Transform& transform);
+	struct CullItem {
+		ST_REF<Mesh> _mesh;
+
+		glm::mat4 _model;
+
+		AABB _worldBox;
+	};
+
+	/*
+	 * Padded so threads appending to neighbouring lists do not share a cache line. The vector holding these is
+	 * only 16 byte aligned (over-aligned new needs C++17), so a 64 byte stride could still put two headers on one
+	 * line, a 128 byte stride cannot.
+	 */
+	struct ThreadDrawList {
+		ST_VECTOR<DrawItem> _items;
+
+		char _padding[128 - sizeof(ST_VECTOR<DrawItem>)];
+	};
+
+	struct MergeHead {
+		uint64_t _sortKey;
+
+		uint32_t _list;
+
+		uint32_t _cursor;
+	};
+
+	struct InstanceBatch {
+		ST_REF<Mesh> _mesh;
+
+		ST_REF<Material> _material;
+
+		ST_VECTOR<glm::mat4> _models;
+	};
+
+	glm::mat4 CreateModelMat(const Transform& transform) const;
+
+	static DrawItem MakeDrawItem(const ST_REF<Mesh>& mesh, const glm::mat4& modelTrans, const glm::vec3& eyePos,
+		float cameraFar);
+
+	/* k-way merge of the sorted per-thread lists */
+	void MergeThreadDrawLists(ST_VECTOR<DrawItem>& outItems);
+
+	void SubmitModel(const ST_REF<Model>& model, const glm::mat4& modelTrans);
+
+	void AddToInstanceBatch(const ST_REF<Mesh>& mesh, const glm::mat4& modelTrans);
+
+	void FlushInstanceBatches();
 
 	void DrawModelByColor(ST_REF<Model> model, const Transform& transform, const glm::vec4& color);
 
@@ -73,8 +213,38 @@ private:
 
 	ST_REF<Shader> _shader;
 
+	/* from the packet of the frame being drawn */
+	glm::mat4 _viewProj{1.f};
+
+	glm::vec3 _eyePos{0.f};
+
+	float _cameraFar = 1.f;
+
 	ST_REF<FrameBuffer> _frameBuffer;
 
+	ST_REF<UniformBuffer> _cameraUniformBuffer;
+
+	ST_REF<UniformBuffer> _lightUniformBuffer;
+
 	ST_REF<CubeMap> _skyBox;
+
+	/* Submitted meshes waiting for the frustum test, _cullSpheres[i] belongs to _cullItems[i] */
+	ST_VECTOR<CullItem> _cullItems;
+
+	SphereBatch _cullSpheres;
+
+	ST_VECTOR<uint8_t> _cullVisible;
+
+	ST_MAP<std::pair<const Mesh*, const Material*>, InstanceBatch> _instanceBatches;
+
+	RenderQueue _renderQueue;
+
+	/* CollectDrawItems scratch, one list per job system thread and a last one for callers outside of it */
+	ST_VECTOR<ThreadDrawList> _threadDrawLists;
+
+	ST_VECTOR<MergeHead> _mergeHeads;
+
+	/* SubmitDrawItems scratch */
+	ST_VECTOR<glm::mat4> _runModels;
 };
 }
@@ -3,103 +3,189 @@
 #include "Light.h"
 #include "Material.h"
 #include "PathManager.h"
+#include "ShaderCache.h"
 #include "gtc/type_ptr.hpp"
 #include "Resource/ResourceManager.h"
 
 namespace ST {
-Shader::Shader(ST_STRING vertShaderPath, ST_STRING fragShaderPath) {
-	ST_STRING vertSource;
-	ResourceManager::GetResourceManager().LoadFileToStr(PathManager::GetFullPath(vertShaderPath), vertSource);
-	const char* vertShaderSource = vertSource.c_str();
-	unsigned int vertShader      = glCreateShader(GL_VERTEX_SHADER);
-
-	glShaderSource(vertShader, 1, &vertShaderSource,NULL);
-	glCompileShader(vertShader);
+Shader::Shader(ST_STRING vertShaderPath, ST_STRING fragShaderPath):
+	_vertFullPath(PathManager::GetFullPath(vertShaderPath)), _fragFullPath(PathManager::GetFullPath(fragShaderPath)) {
+	ST_STRING vertSource, fragSource;
+	ResourceManager::GetResourceManager().LoadFileToStr(_vertFullPath, vertSource);
+	ResourceManager::GetResourceManager().LoadFileToStr(_fragFullPath, fragSource);
+
+	uint64_t cacheKey = ShaderCache::MakeKey(vertSource, fragSource);
+	_shaderId         = ShaderCache::Load(_vertFullPath, cacheKey);
+	if (!_shaderId) {
+		_shaderId = CompileProgram(vertSource, fragSource);
+		if (!_shaderId)
+			return;
+		ShaderCache::Save(_vertFullPath, cacheKey, _shaderId);
+	}
+
+	ReflectUniforms();
+	BindUniformBlocks();
+}
+
+Shader::~Shader() {
+	if (_shaderId)
+		glDeleteProgram(_shaderId);
+}
+
+void Shader::ReplaceProgram(unsigned int program, uint64_t cacheKey) {
+	if (_shaderId)
+		glDeleteProgram(_shaderId);
+	_shaderId = program;
+	ReflectUniforms();
+	BindUniformBlocks();
+	ShaderCache::Save(_vertFullPath, cacheKey, _shaderId);
+	ST_LOG("Shader reloaded: %s\n", _vertFullPath.c_str());
+}
+
+unsigned int Shader::CompileStage(unsigned int stage, const ST_STRING& source) {
+	const char* shaderSource = source.c_str();
+	unsigned int shader      = glCreateShader(stage);
+	glShaderSource(shader, 1, &shaderSource,NULL);
+	glCompileShader(shader);
 	int success;
-	glGetShaderiv(vertShader,GL_COMPILE_STATUS, &success);
+	glGetShaderiv(shader,GL_COMPILE_STATUS, &success);
 	if (!success) {
 		char info[512];
-		glGetShaderInfoLog(vertShader, 512,NULL, info);
-		ST_ERROR("Vert Shader Compiler Failed! ::%s\n",info);
-		return;
+		glGetShaderInfoLog(shader, 512,NULL, info);
+		ST_ERROR("%s Shader Compiler Failed! ::%s\n", stage == GL_VERTEX_SHADER ? "Vert" : "Frag", info);
+		glDeleteShader(shader);
+		return 0;
 	}
+	return shader;
+}
 
-	ST_STRING fragSource;
-	ResourceManager::GetResourceManager().LoadFileToStr(PathManager::GetFullPath(fragShaderPath), fragSource);
-	const char* fragShaderSource = fragSource.c_str();
-	unsigned int fragShader      = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragShader, 1, &fragShaderSource,NULL);
-	glCompileShader(fragShader);
-	glGetShaderiv(fragShader,GL_COMPILE_STATUS, &success);
-	if (!success) {
-		char info[512];
-		glGetShaderInfoLog(fragShader, 512,NULL, info);
-		ST_ERROR("Frag Shader Compiler Failed! ::%s\n",info);
-		return;
+unsigned int Shader::CompileProgram(const ST_STRING& vertSource, const ST_STRING& fragSource) {
+	unsigned int vertShader = CompileStage(GL_VERTEX_SHADER, vertSource);
+	if (!vertShader)
+		return 0;
+	unsigned int fragShader = CompileStage(GL_FRAGMENT_SHADER, fragSource);
+	if (!fragShader) {
+		glDeleteShader(vertShader);
+		return 0;
 	}
 
-	_shaderId = glCreateProgram();
-	glAttachShader(_shaderId, vertShader);
-	glAttachShader(_shaderId, fragShader);
-	glLinkProgram(_shaderId);
-	glGetProgramiv(_shaderId,GL_COMPILE_STATUS, &success);
+	unsigned int program = glCreateProgram();
+	glAttachShader(program, vertShader);
+	glAttachShader(program, fragShader);
+	ShaderCache::MarkRetrievable(program);
+	glLinkProgram(program);
+	glDeleteShader(vertShader);
+	glDeleteShader(fragShader);
+
+	int success;
+	glGetProgramiv(program,GL_LINK_STATUS, &success);
 	if (!success) {
 		char info[512];
-		glGetProgramInfoLog(_shaderId, 512,NULL, info);
+		glGetProgramInfoLog(program, 512,NULL, info);
 		std::cout << "Program Link Failed! ::" << info;
-		return;
+		glDeleteProgram(program);
+		return 0;
 	}
+	return program;
+}
 
-	glDeleteShader(vertShader);
-	glDeleteShader(fragShader);
+void Shader::BindUniformBlocks() const {
+	static const std::pair<const char*, uint32_t> blocks[] = {
+		{"CameraBlock", CAMERA_BLOCK_BINDING},
+		{"LightBlock", LIGHT_BLOCK_BINDING}
+	};
+	for (const auto& block : blocks) {
+		unsigned int blockIndex = glGetUniformBlockIndex(_shaderId, block.first);
+		if (blockIndex != GL_INVALID_INDEX) {
+			glUniformBlockBinding(_shaderId, blockIndex, block.second);
+		}
+	}
+}
+
+void Shader::ReflectUniforms() {
+	_uniformLocations.clear();
+	int uniformCount = 0, maxNameLength = 0;
+	glGetProgramiv(_shaderId, GL_ACTIVE_UNIFORMS, &uniformCount);
+	glGetProgramiv(_shaderId, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+	ST_STRING name(maxNameLength, '\0');
+	for (int i = 0; i < uniformCount; ++i) {
+		GLsizei length = 0;
+		GLint size     = 0;
+		GLenum type    = 0;
+		glGetActiveUniform(_shaderId, i, maxNameLength, &length, &size, &type, &name[0]);
+		ST_STRING uniformName = name.substr(0, length);
+		int location          = glGetUniformLocation(_shaderId, uniformName.c_str());
+		// Members of uniform blocks are active but have no location
+		if (location < 0) {
+			continue;
+		}
+		_uniformLocations[HashUniformName(uniformName.c_str())] = location;
+
+		// Arrays are reported as "name[0]", register the bare name and every element
+		auto bracket = uniformName.find('[');
+		if (bracket != ST_STRING::npos) {
+			ST_STRING baseName = uniformName.substr(0, bracket);
+			_uniformLocations[HashUniformName(baseName.c_str())] = location;
+			for (int element = 1; element < size; ++element) {
+				ST_STRING elementName = baseName + "[" + std::to_string(element) + "]";
+				_uniformLocations[HashUniformName(elementName.c_str())] =
+					glGetUniformLocation(_shaderId, elementName.c_str());
+			}
+		}
+	}
 }
 
 ST_REF<Shader> Shader::CreateShader(ST_STRING vertShaderPath, ST_STRING fragShaderPath) {
 	return ST_MAKE_REF<Shader>(vertShaderPath, fragShaderPath);
 }
 
-void Shader::SetInt(ST_STRING propName, int value) const {
-	glUniform1i(glGetUniformLocation(GetShaderId(), propName.c_str()), value);
+void Shader::SetInt(UniformName propName, int value) const {
+	glUniform1i(GetUniformLocation(propName), value);
+}
+
+void Shader::SetIntArray(UniformName propName, const int* values, uint32_t count) const {
+	glUniform1iv(GetUniformLocation(propName), count, values);
 }
 
-void Shader::SetFloat(ST_STRING propName, float value) const {
-	glUniform1f(glGetUniformLocation(GetShaderId(), propName.c_str()), value);
+void Shader::SetFloat(UniformName propName, float value) const {
+	glUniform1f(GetUniformLocation(propName), value);
 }
 
-void Shader::SetMat4(ST_STRING propName, glm::mat4 mat) const {
-	glUniformMatrix4fv(glGetUniformLocation(GetShaderId(), propName.c_str()), 1,GL_FALSE, glm::value_ptr(mat));
+void Shader::SetMat4(UniformName propName, const glm::mat4& mat) const {
+	glUniformMatrix4fv(GetUniformLocation(propName), 1,GL_FALSE, glm::value_ptr(mat));
 }
 
-void Shader::SetVec3(ST_STRING propName, glm::vec3 vec) const {
-	glUniform3fv(glGetUniformLocation(GetShaderId(), propName.c_str()), 1, glm::value_ptr(vec));
+void Shader::SetVec3(UniformName propName, const glm::vec3& vec) const {
+	glUniform3fv(GetUniformLocation(propName), 1, glm::value_ptr(vec));
 }
 
-void Shader::SetVec4(ST_STRING propName, glm::vec4 vec) const {
-	glUniform4fv(glGetUniformLocation(GetShaderId(), propName.c_str()), 1, glm::value_ptr(vec));
+void Shader::SetVec4(UniformName propName, const glm::vec4& vec) const {
+	glUniform4fv(GetUniformLocation(propName), 1, glm::value_ptr(vec));
 }
 
-void Shader::SetDirLight(ST_STRING proName, ST_REF<DirLight> light) const {
-	SetVec3(proName + ".f_Dir", light->_dir);
-	SetVec3(proName + ".f_Ia", light->_ia);
-	SetVec3(proName + ".f_Id", light->_id);
-	SetVec3(proName + ".f_Is", light->_is);
+void Shader::SetDirLight(UniformName proName, ST_REF<DirLight> light) const {
+	SetVec3(proName.Member("f_Dir"), light->_dir);
+	SetVec3(proName.Member("f_Ia"), light->_ia);
+	SetVec3(proName.Member("f_Id"), light->_id);
+	SetVec3(proName.Member("f_Is"), light->_is);
 }
 
-void Shader::SetPointLight(ST_STRING proName, ST_REF<PointLight> light) const {
-	SetVec3(proName + ".f_LightPos", light->_pos);
-	SetVec3(proName + ".f_Ia", light->_ia);
-	SetVec3(proName + ".f_Id", light->_id);
-	SetVec3(proName + ".f_Is", light->_is);
-	SetFloat(proName + ".f_Const", light->_const);
-	SetFloat(proName + ".f_Linear", light->_linear);
-	SetFloat(proName + ".f_Quadratic", light->_quadratic);
+void Shader::SetPointLight(UniformName proName, ST_REF<PointLight> light) const {
+	SetVec3(proName.Member("f_LightPos"), light->_pos);
+	SetVec3(proName.Member("f_Ia"), light->_ia);
+	SetVec3(proName.Member("f_Id"), light->_id);
+	SetVec3(proName.Member("f_Is"), light->_is);
+	SetFloat(proName.Member("f_Const"), light->_const);
+	SetFloat(proName.Member("f_Linear"), light->_linear);
+	SetFloat(proName.Member("f_Quadratic"), light->_quadratic);
 }
 
-void Shader::SetMaterial(ST_STRING proName, ST_REF<Material> material) const {
+void Shader::SetMaterial(UniformName proName, ST_REF<Material> material) const {
 	int idx = material->_idx * 3;
-	SetInt(proName + ".f_Ka", idx);
-	SetInt(proName + ".f_Kd", idx + 1);
-	SetInt(proName + ".f_Ks", idx + 2);
-	SetFloat(proName + ".f_Shinness", material->_shinness);
+	SetInt(proName.Member("f_Ka"), idx);
+	SetInt(proName.Member("f_Kd"), idx + 1);
+	SetInt(proName.Member("f_Ks"), idx + 2);
+	SetFloat(proName.Member("f_Shinness"), material->_shinness);
 }
 }
@@ -12,10 +12,43 @@ class PointLight;
 
 class DirLight;
 
+/* Uniform blocks shared by every program, Shader binds them to these points after linking */
+enum UniformBlockBinding : uint32_t {
+	CAMERA_BLOCK_BINDING = 0,
+	LIGHT_BLOCK_BINDING  = 1
+};
+
+/* FNV-1a, continuing from a struct's hash yields the hash of "struct.member" */
+constexpr uint32_t HashUniformName(const char* name, uint32_t hash = 2166136261u) {
+	return *name == '\0' ? hash : HashUniformName(name + 1, (hash ^ static_cast<uint8_t>(*name)) * 16777619u);
+}
+
+/* Hashed uniform name, constexpr when built from a literal so hot paths never touch strings */
+struct UniformName {
+	constexpr UniformName(const char* name): _hash(HashUniformName(name)) {}
+
+	UniformName(const ST_STRING& name): _hash(HashUniformName(name.c_str())) {}
+
+	constexpr UniformName Member(const char* member) const {
+		return UniformName(HashUniformName(member, HashUniformName(".", _hash)), 0);
+	}
+
+	uint32_t _hash;
+
+private:
+	constexpr UniformName(uint32_t hash, int): _hash(hash) {}
+};
+
 class Shader {
 public:
 	Shader(ST_STRING vertShaderPath, ST_STRING fragShaderPath);
 
+	~Shader();
+
+	Shader(const Shader&) = delete;
+
+	Shader& operator=(const Shader&) = delete;
+
 	static ST_REF<Shader> CreateShader(ST_STRING vertShaderPath, ST_STRING fragShaderPath);
 
 	inline void UseShader() const {
@@ -26,24 +59,59 @@ public:
 		return _shaderId;
 	}
 
-	void SetInt(ST_STRING propName, int value) const;
+	inline const ST_STRING& GetVertFullPath() const {
+		return _vertFullPath;
+	}
 
-	void SetFloat(ST_STRING propName, float value) const;
+	inline const ST_STRING& GetFragFullPath() const {
+		return _fragFullPath;
+	}
+
+	/* Takes ownership of a program linked from this shader's edited sources, used by hot reload between frames */
+	void ReplaceProgram(unsigned int program, uint64_t cacheKey);
+
+	/* Compiles and links from source, 0 on failure after logging the driver's message. Safe on any thread
+	   with a current context */
+	static unsigned int CompileProgram(const ST_STRING& vertSource, const ST_STRING& fragSource);
+
+	/* -1 if the program has no such active uniform, which glUniform* silently ignores */
+	inline int GetUniformLocation(UniformName propName) const {
+		auto it = _uniformLocations.find(propName._hash);
+		return it != _uniformLocations.end() ? it->second : -1;
+	}
+
+	void SetInt(UniformName propName, int value) const;
+
+	void SetIntArray(UniformName propName, const int* values, uint32_t count) const;
 
-	void SetMat4(ST_STRING propName, glm::mat4 mat) const;
+	void SetFloat(UniformName propName, float value) const;
 
-	void SetVec3(ST_STRING propName, glm::vec3 vec) const;
+	void SetMat4(UniformName propName, const glm::mat4& mat) const;
 
-	void SetVec4(ST_STRING propName, glm::vec4 vec) const;
+	void SetVec3(UniformName propName, const glm::vec3& vec) const;
 
-	void SetDirLight(ST_STRING proName, ST_REF<DirLight> light) const;
+	void SetVec4(UniformName propName, const glm::vec4& vec) const;
 
-	void SetPointLight(ST_STRING proName,ST_REF<PointLight> light) const;
+	void SetDirLight(UniformName proName, ST_REF<DirLight> light) const;
 
-	void SetMaterial(ST_STRING proName,ST_REF<Material> material) const;
+	void SetPointLight(UniformName proName,ST_REF<PointLight> light) const;
+
+	void SetMaterial(UniformName proName,ST_REF<Material> material) const;
 
 protected:
-	unsigned int _shaderId;
+	static unsigned int CompileStage(unsigned int stage, const ST_STRING& source);
+
+	void ReflectUniforms();
+
+	void BindUniformBlocks() const;
+
+	unsigned int _shaderId = 0;
+
+	ST_STRING _vertFullPath;
+
+	ST_STRING _fragFullPath;
+
+	ST_UNORDERED_MAP<uint32_t, int> _uniformLocations;
 
 };
 }
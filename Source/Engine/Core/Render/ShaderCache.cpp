@@ -0,0 +1,158 @@
+#include "ShaderCache.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include "MappedFile.h"
+
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+namespace ST {
+namespace {
+/* glad is generated for core 3.3 only, so ARB_get_program_binary is fetched by hand */
+typedef void (APIENTRYP GetProgramBinaryProc)(GLuint program, GLsizei bufSize, GLsizei* length,
+	GLenum* binaryFormat, void* binary);
+typedef void (APIENTRYP ProgramBinaryProc)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+typedef void (APIENTRYP ProgramParameteriProc)(GLuint program, GLenum pname, GLint value);
+
+struct ProgramBinaryApi {
+	GetProgramBinaryProc _getProgramBinary = nullptr;
+
+	ProgramBinaryProc _programBinary = nullptr;
+
+	ProgramParameteriProc _programParameteri = nullptr;
+
+	bool _supported = false;
+};
+
+const ProgramBinaryApi& GetProgramBinaryApi() {
+	static ProgramBinaryApi api = [] {
+		ProgramBinaryApi result;
+		if (!glfwExtensionSupported("GL_ARB_get_program_binary") && !(GLVersion.major > 4 ||
+			(GLVersion.major == 4 && GLVersion.minor >= 1)))
+			return result;
+		result._getProgramBinary  = reinterpret_cast<GetProgramBinaryProc>(glfwGetProcAddress("glGetProgramBinary"));
+		result._programBinary     = reinterpret_cast<ProgramBinaryProc>(glfwGetProcAddress("glProgramBinary"));
+		result._programParameteri = reinterpret_cast<ProgramParameteriProc>(glfwGetProcAddress("glProgramParameteri"));
+		int formatCount = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+		result._supported = result._getProgramBinary && result._programBinary && result._programParameteri &&
+			formatCount > 0;
+		return result;
+	}();
+	return api;
+}
+
+struct CacheHeader {
+	uint32_t _magic;
+
+	uint32_t _version;
+
+	uint64_t _key;
+
+	uint32_t _binaryFormat;
+
+	uint32_t _binaryLength;
+};
+
+/* FNV-1a 64 over raw bytes */
+uint64_t HashContinue(uint64_t hash, const char* data, size_t size) {
+	for (size_t i = 0; i < size; ++i) {
+		hash = (hash ^ static_cast<uint8_t>(data[i])) * 1099511628211ull;
+	}
+	return hash;
+}
+
+uint64_t HashGLString(uint64_t hash, GLenum name) {
+	const char* value = reinterpret_cast<const char*>(glGetString(name));
+	return value ? HashContinue(hash, value, strlen(value) + 1) : hash;
+}
+}
+
+bool ShaderCache::IsSupported() {
+	return GetProgramBinaryApi()._supported;
+}
+
+uint64_t ShaderCache::MakeKey(const ST_STRING& vertSource, const ST_STRING& fragSource) {
+	/* the terminating nulls separate the strings, so moving text between them changes the key */
+	uint64_t hash = HashContinue(14695981039346656037ull, vertSource.c_str(), vertSource.size() + 1);
+	hash = HashContinue(hash, fragSource.c_str(), fragSource.size() + 1);
+	hash = HashGLString(hash, GL_VENDOR);
+	hash = HashGLString(hash, GL_RENDERER);
+	return HashGLString(hash, GL_VERSION);
+}
+
+ST_STRING ShaderCache::GetCachePath(const ST_STRING& vertFullPath) {
+	return vertFullPath + ".stprog";
+}
+
+unsigned int ShaderCache::Load(const ST_STRING& vertFullPath, uint64_t key) {
+	if (!IsSupported())
+		return 0;
+
+	MappedFile file;
+	if (!file.Open(GetCachePath(vertFullPath)) || file.GetSize() < sizeof(CacheHeader))
+		return 0;
+	CacheHeader header;
+	memcpy(&header, file.GetData(), sizeof(header));
+	if (header._magic != MAGIC || header._version != VERSION || header._key != key ||
+		file.GetSize() - sizeof(header) < header._binaryLength)
+		return 0;
+
+	unsigned int program = glCreateProgram();
+	GetProgramBinaryApi()._programBinary(program, header._binaryFormat, file.GetData() + sizeof(header),
+		static_cast<GLsizei>(header._binaryLength));
+	/* drivers reject binaries from other builds with a failed link status rather than an error */
+	int success = 0;
+	glGetProgramiv(program, GL_LINK_STATUS, &success);
+	if (!success) {
+		glDeleteProgram(program);
+		return 0;
+	}
+	return program;
+}
+
+bool ShaderCache::Save(const ST_STRING& vertFullPath, uint64_t key, unsigned int program) {
+	if (!IsSupported())
+		return false;
+
+	int length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0)
+		return false;
+	ST_VECTOR<char> binary(length);
+	GLenum format = 0;
+	GetProgramBinaryApi()._getProgramBinary(program, length, &length, &format, binary.data());
+
+	CacheHeader header{MAGIC, VERSION, key, format, static_cast<uint32_t>(length)};
+	ST_STRING cachePath = GetCachePath(vertFullPath);
+	ST_STRING tempPath  = cachePath + ".tmp";
+	std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+	if (!stream.is_open()) {
+		ST_LOG("Shader cache write failed! %s\n", tempPath.c_str());
+		return false;
+	}
+	stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	stream.write(binary.data(), length);
+	stream.close();
+	if (stream.fail()) {
+		std::remove(tempPath.c_str());
+		return false;
+	}
+	std::remove(cachePath.c_str());
+	return std::rename(tempPath.c_str(), cachePath.c_str()) == 0;
+}
+
+void ShaderCache::MarkRetrievable(unsigned int program) {
+	if (IsSupported())
+		GetProgramBinaryApi()._programParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include "Core.h"
+
+namespace ST {
+/*
+ * Linked program binaries stored next to the vertex shader as "<vert>.stprog". Entries are keyed by a
+ * hash of both sources and the driver's vendor, renderer and version strings, so an edited shader or a
+ * driver update just falls back to compiling from source.
+ */
+class ShaderCache {
+public:
+	static constexpr uint32_t MAGIC   = 0x47525053; // "SPRG"
+	static constexpr uint32_t VERSION = 1;
+
+	/* Needs GL 4.1 or ARB_get_program_binary and at least one binary format, entry points load lazily */
+	static bool IsSupported();
+
+	static uint64_t MakeKey(const ST_STRING& vertSource, const ST_STRING& fragSource);
+
+	static ST_STRING GetCachePath(const ST_STRING& vertFullPath);
+
+	/* Linked program, or 0 if the cache is missing, stale or rejected by the driver */
+	static unsigned int Load(const ST_STRING& vertFullPath, uint64_t key);
+
+	static bool Save(const ST_STRING& vertFullPath, uint64_t key, unsigned int program);
+
+	/* Call before glLinkProgram so the driver keeps a retrievable binary */
+	static void MarkRetrievable(unsigned int program);
+};
+}
@@ -1,9 +1,24 @@
 ﻿#include "Texture2D.h"
 
 #include "PathManager.h"
+#include "Profiler.h"
 #include "ResourceManager.h"
 
 namespace ST {
+uint64_t Texture2D::s_currentFrame = 0;
+
+Texture2D::Texture2D() {
+	glGenTextures(1, &_textureId);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, _textureId);
+	glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_S,GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_T,GL_REPEAT);
+	const unsigned char white[4] = {255, 255, 255, 255};
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA,GL_UNSIGNED_BYTE, white);
+	_gpuBytes = sizeof(white);
+}
 
 Texture2D::Texture2D(unsigned int width, unsigned int height) {
 	glGenTextures(1, &_textureId);
@@ -14,6 +29,7 @@ Texture2D::Texture2D(unsigned int width, unsigned int height) {
 	glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_S,GL_CLAMP_TO_EDGE);
 	glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_T,GL_CLAMP_TO_EDGE);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB,GL_UNSIGNED_BYTE, nullptr);
+	_gpuBytes = static_cast<size_t>(width) * height * 3;
 }
 
 Texture2D::Texture2D(ST_STRING imagePath) {
@@ -29,15 +45,7 @@ Texture2D::Texture2D(ST_STRING imagePath) {
 	auto image = ResourceManager::GetResourceManager().LoadImageToCharPtr(PathManager::GetFullPath(imagePath),
 		width, height, channel);
 	if (image) {
-		GLenum format;
-		if (channel == 1)
-			format = GL_RED;
-		else if (channel == 3)
-			format = GL_RGB;
-		else
-			format = GL_RGBA;
-		glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format,GL_UNSIGNED_BYTE, image);
-		glGenerateMipmap(GL_TEXTURE_2D);
+		UploadImage(width, height, channel, image);
 		ResourceManager::GetResourceManager().UnloadImage(image);
 	}
 	else {
@@ -46,7 +54,26 @@ Texture2D::Texture2D(ST_STRING imagePath) {
 
 }
 
-Texture2D::Texture2D(unsigned width, unsigned height, unsigned char* buffer) {
+void Texture2D::UploadImage(int width, int height, int channel, const void* pixels) {
+	GLenum format;
+	if (channel == 1)
+		format = GL_RED;
+	else if (channel == 3)
+		format = GL_RGB;
+	else
+		format = GL_RGBA;
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, _textureId);
+	glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format,GL_UNSIGNED_BYTE, pixels);
+	glGenerateMipmap(GL_TEXTURE_2D);
+	/* a full mip chain adds a third on top of the base level */
+	_gpuBytes = static_cast<size_t>(width) * height * channel * 4 / 3;
+	/* pixels come from a bound unpack buffer when null, the loader counted those already */
+	if (pixels)
+		ST_PROFILE_UPLOAD(static_cast<size_t>(width) * height * channel);
+}
+
+Texture2D::Texture2D(unsigned width, unsigned height, unsigned char* buffer, bool bCoverage) {
 	glGenTextures(1, &_textureId);
 	glActiveTexture(GL_TEXTURE0);
 	glBindTexture(GL_TEXTURE_2D, _textureId);
@@ -54,7 +81,13 @@ Texture2D::Texture2D(unsigned width, unsigned height, unsigned char* buffer) {
 	glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_S,GL_CLAMP_TO_EDGE);
 	glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_T,GL_CLAMP_TO_EDGE);
+	if (bCoverage) {
+		const GLint swizzle[] = {GL_ONE, GL_ONE, GL_ONE, GL_RED};
+		glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+	}
 	glTexImage2D(GL_TEXTURE_2D, 0,GL_RED, width, height, 0,GL_RED,GL_UNSIGNED_BYTE, buffer);
+	_gpuBytes = static_cast<size_t>(width) * height;
+	ST_PROFILE_UPLOAD(_gpuBytes);
 }
 
 }
@@ -1,24 +1,30 @@
 ﻿#pragma once
 
 #include"Core.h"
+#include "ResourceRegistry.h"
 
 namespace ST {
 class FrameBuffer;
 
 class Texture2D {
 public:
+	/* 1x1 white stand-in for an image still being decoded, UploadImage later replaces it in place */
+	Texture2D();
+
 	Texture2D(unsigned int width, unsigned int height);
 	friend FrameBuffer;
 	
 	Texture2D(ST_STRING imagePath);
 
-	Texture2D(unsigned int width, unsigned int height, unsigned char* buffer);
+	/* Single channel. bCoverage samples it as white with red as alpha, for glyph atlases drawn by the UI batch */
+	Texture2D(unsigned int width, unsigned int height, unsigned char* buffer, bool bCoverage = false);
 
 	inline ~Texture2D() {
 		glDeleteTextures(1, &_textureId);
 	}
 
 	inline void Bind(int index) const {
+		_lastBoundFrame = s_currentFrame;
 		glActiveTexture(GL_TEXTURE0 + index);
 		glBindTexture(GL_TEXTURE_2D, _textureId);
 	}
@@ -28,7 +34,40 @@ public:
 		glBindTexture(GL_TEXTURE_2D, 0);
 	}
 
+	/* pixels may be an offset into the bound GL_PIXEL_UNPACK_BUFFER, mipmaps are regenerated */
+	void UploadImage(int width, int height, int channel, const void* pixels);
+
+	inline uint32_t GetTextureId() const {
+		return _textureId;
+	}
+
+	/* Estimated video memory including the mip chain */
+	inline size_t GetGpuBytes() const {
+		return _gpuBytes;
+	}
+
+	inline uint64_t GetLastBoundFrame() const {
+		return _lastBoundFrame;
+	}
+
+	inline static uint64_t GetCurrentFrame() {
+		return s_currentFrame;
+	}
+
+	/* Called once per frame, Bind stamps textures with the current frame for LRU eviction */
+	inline static void AdvanceFrame() {
+		++s_currentFrame;
+	}
+
 private:
 	uint32_t _textureId{};
+
+	size_t _gpuBytes = 0;
+
+	mutable uint64_t _lastBoundFrame = 0;
+
+	static uint64_t s_currentFrame;
 };
+
+using TextureHandle = ResourceHandle<Texture2D>;
 }
@@ -15,25 +15,45 @@ namespace ST
         vertexBuffer->Bind();
 
         _vertexBuffers.push_back(vertexBuffer);
+        AddLayout(vertexBuffer->GetBufferLayout());
+    }
+
+    void VertexArray::AddStreamingBuffer(ST_REF<StreamingBuffer> streamingBuffer)
+    {
+        glBindVertexArray(_arraryId);
+        streamingBuffer->Bind();
+
+        _streamingBuffers.push_back(streamingBuffer);
+        AddLayout(streamingBuffer->GetBufferLayout());
+    }
+
+    void VertexArray::AddLayout(const BufferLayout& layout)
+    {
         int stride=0;
-        for(auto& element : vertexBuffer->GetBufferLayout())
+        for(auto& element : layout)
         {
             stride+=GetShaderDataTypeSize(element._type);
         }
-        int index=0;
         int offset=0;
-        for(auto& element : vertexBuffer->GetBufferLayout())
+        for(auto& element : layout)
         {
-            glVertexAttribPointer(
-                index,
-                GetShaderDataTypeCount(element._type),
-                ShaderDataType2GLType(element._type),
-                element.normalized? GL_TRUE:GL_FALSE,
-                stride,
-                (void*)offset);
-            glEnableVertexAttribArray(index);
-            offset+=GetShaderDataTypeSize(element._type);
-            ++index;
+            // matrices occupy one attribute location per column
+            int columnCount=element._type==ShaderDataType::Mat4? 4:element._type==ShaderDataType::Mat3? 3:1;
+            int columnSize=GetShaderDataTypeSize(element._type)/columnCount;
+            for(int column=0;column<columnCount;++column)
+            {
+                glVertexAttribPointer(
+                    _vertexAttribIndex,
+                    GetShaderDataTypeCount(element._type)/columnCount,
+                    ShaderDataType2GLType(element._type),
+                    element.normalized? GL_TRUE:GL_FALSE,
+                    stride,
+                    (void*)offset);
+                glEnableVertexAttribArray(_vertexAttribIndex);
+                glVertexAttribDivisor(_vertexAttribIndex,element._divisor);
+                offset+=columnSize;
+                ++_vertexAttribIndex;
+            }
         }
     }
 
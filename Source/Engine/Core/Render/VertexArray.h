@@ -8,6 +8,10 @@ class VertexBuffer;
 
 class IndexBuffer;
 
+class StreamingBuffer;
+
+struct BufferLayout;
+
 class VertexArray {
 
 public:
@@ -25,16 +29,30 @@ public:
 		glBindVertexArray(0);
 	}
 
+	inline uint32_t GetArrayId() const {
+		return _arraryId;
+	}
+
 	void AddVertexBuffer(ST_REF<VertexBuffer> vertexBuffer);
 
+	/* Attributes point at the start of the ring, draw each allocation with a base vertex of offset / stride */
+	void AddStreamingBuffer(ST_REF<StreamingBuffer> streamingBuffer);
+
 	void SetIndexBuffer(ST_REF<IndexBuffer> indexBuffer);
 
 	ST_VECTOR<ST_REF<VertexBuffer>> _vertexBuffers;
 
 	ST_REF<IndexBuffer> _indexBuffer;
 
+	ST_VECTOR<ST_REF<StreamingBuffer>> _streamingBuffers;
+
 private:
+	void AddLayout(const BufferLayout& layout);
+
 	unsigned int _arraryId;
 
+	/* Next free attribute location, later buffers continue after the earlier ones */
+	unsigned int _vertexAttribIndex = 0;
+
 };
 }
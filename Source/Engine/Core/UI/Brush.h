@@ -15,11 +15,15 @@ struct Brush {
 	}
 
 	void SetTexture(const ST_STRING& texPath) {
-		_texPath = texPath;
+		_texPath   = texPath;
+		_texHandle = TextureHandle();
 	}
 
 	glm::vec4 _color;
 
 	ST_STRING _texPath;
+
+	/* Resolved from _texPath the first time UIDrawList records the brush, later frames only touch the handle */
+	mutable TextureHandle _texHandle;
 };
 }
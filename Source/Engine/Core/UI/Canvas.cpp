@@ -5,7 +5,7 @@
 #include "UI_Button.h"
 #include "UI_Image.h"
 #include "Event/Event.h"
-#include "Render/Renderer2D.h"
+#include "UIDrawList.h"
 
 ST::Canvas::Canvas(Rect&& rect): _rect(rect) {
 	auto button = ST_MAKE_REF<UI_Button>(Rect{100, 800, 100, 30}, nullptr, this);
@@ -41,9 +41,9 @@ ST::Canvas::Canvas(Rect&& rect): _rect(rect) {
 	// AddChild(ST_MAKE_REF<UI_Image>(Rect{300,300,300,30},this,nullptr));
 }
 
-void ST::Canvas::Draw(const ST_REF<Renderer2D>& renderer) {
+void ST::Canvas::Draw(UIDrawList& drawList) {
 	for (auto& widget : _children) {
-		widget->Draw(renderer);
+		widget->Draw(drawList);
 	}
 	// renderer->DrawSingleChar({100,100,40,40},'c');
 	// renderer->DrawSingleChar({200,200,40,40},'C');
@@ -7,7 +7,7 @@ struct Rect;
 
 struct Event;
 
-class Renderer2D;
+class UIDrawList;
 
 class Widget;
 
@@ -20,7 +20,8 @@ public:
 
 	Rect& GetRect() { return _rect; }
 
-	void Draw(const ST_REF<Renderer2D>& renderer);
+	/* Records the widgets, the list is replayed into Renderer2D on the render thread */
+	void Draw(UIDrawList& drawList);
 
 	void AddChild(ST_REF<Widget> child, int idx = -1);
 
@@ -0,0 +1,41 @@
+#include "UIDrawList.h"
+
+#include "ResourceManager.h"
+#include "Render/Renderer2D.h"
+
+void ST::UIDrawList::DrawQuad(const Rect& rect, const Brush& brush) {
+	auto& resourceManager = ResourceManager::GetResourceManager();
+	/* the handle goes stale when the texture is evicted or unloaded, the path finds it again once reloaded */
+	if (!brush._texPath.empty() && !resourceManager.GetTexture(brush._texHandle))
+		brush._texHandle = resourceManager.FindTexture(brush._texPath);
+	bool bResolved = brush._texPath.empty() || brush._texHandle.IsValid();
+	_commands.push_back(Command{CommandType::QUAD, rect, brush._color, brush._texHandle, 0.f,
+		bResolved ? ST_STRING() : brush._texPath});
+}
+
+void ST::UIDrawList::DrawSingleLineText(glm::vec2 pos, glm::vec3 color, float scale, const ST_STRING& text) {
+	_commands.push_back(Command{CommandType::TEXT, Rect(pos.x, pos.y, 0, 0), glm::vec4(color, 1.f), TextureHandle(), scale,
+		text});
+}
+
+void ST::UIDrawList::Clear() {
+	_commands.clear();
+}
+
+void ST::UIDrawList::Replay(Renderer2D& renderer2D) const {
+	for (auto& command : _commands) {
+		switch (command._type) {
+			case CommandType::QUAD: {
+				auto& resourceManager = ResourceManager::GetResourceManager();
+				Texture2D* texture    = resourceManager.GetTexture(command._texture);
+				if (!texture && !command._text.empty())
+					texture = resourceManager.GetTexture(resourceManager.LoadTextureHandle(command._text));
+				renderer2D.DrawQuad(command._rect, command._color, texture);
+				break;
+			}
+			case CommandType::TEXT: renderer2D.DrawSingleLineText(command._rect._pos, glm::vec3(command._color),
+					command._scale, command._text);
+				break;
+		}
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include "Brush.h"
+#include "Core.h"
+#include "Rect.h"
+#include "vec3.hpp"
+#include "vec4.hpp"
+
+namespace ST {
+class Renderer2D;
+
+/* Widget draws recorded on the game thread, replayed into Renderer2D on the render thread */
+class UIDrawList {
+public:
+	/* Records the brush's texture handle. Until the texture is loaded the path is recorded instead, and Replay
+	   loads it on the render thread, which has the GL context */
+	void DrawQuad(const Rect& rect, const Brush& brush);
+
+	void DrawSingleLineText(glm::vec2 pos, glm::vec3 color, float scale, const ST_STRING& text);
+
+	void Clear();
+
+	/* In recording order, between Renderer2D::BeginDraw and EndDraw */
+	void Replay(Renderer2D& renderer2D) const;
+
+private:
+	enum class CommandType {
+		QUAD = 0, TEXT
+	};
+
+	struct Command {
+		CommandType _type;
+
+		Rect _rect;
+
+		glm::vec4 _color;
+
+		TextureHandle _texture;
+
+		float _scale;
+
+		/* the text of TEXT, the texture path of a QUAD whose handle was not resolved yet */
+		ST_STRING _text;
+	};
+
+	ST_VECTOR<Command> _commands;
+};
+}
@@ -15,7 +15,7 @@ class UI_Button : public Widget {
 public:
 	UI_Button(Rect&& rect, Widget* parent, Canvas* canvas);
 
-	virtual void Draw(const ST_REF<Renderer2D>& renderer2D) override;
+	virtual void Draw(UIDrawList& drawList) override;
 
 	virtual void OnMouseButtonPressed(const MouseButtonPressedEvent& e) override {
 		_mode = ButtonMode::PRESSED;
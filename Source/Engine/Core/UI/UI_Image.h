@@ -5,7 +5,7 @@
 #include "Widget.h"
 
 namespace ST {
-class Renderer2D;
+class UIDrawList;
 
 class Canvas;
 
@@ -17,7 +17,7 @@ class UI_Image : public Widget {
 public:
 	UI_Image(Rect&& rect, Widget* parent, Canvas* canvas);
 
-	virtual void Draw(const ST_REF<Renderer2D>& renderer2D) override;
+	virtual void Draw(UIDrawList& drawList) override;
 
 	Brush _brush;
 };
@@ -10,7 +10,7 @@ struct Rect;
 
 class Canvas;
 
-class Renderer2D;
+class UIDrawList;
 
 class Widget {
 public:
@@ -32,7 +32,7 @@ public:
 
 	void AddChild(ST_REF<Widget> child, int idx = -1);
 
-	virtual void Draw(const ST_REF<Renderer2D>& render2D) {}
+	virtual void Draw(UIDrawList& drawList) {}
 
 	virtual void OnMouseButtonPressed(const MouseButtonPressedEvent& e);
 
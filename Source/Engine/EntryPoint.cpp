@@ -1,4 +1,9 @@
 #include "Application.h"
+
+#include <chrono>
+#include <thread>
+
+#include "Profiler.h"
 using namespace ST;
 
 extern Application* CreateApplication();
@@ -15,10 +20,24 @@ int main(int argc, char* argv[]){
         }
         else{
             float currentTime = app->GetAPPCurrentTime();
-            float deltaTime   = currentTime - cachedTime;
+            float deltaTime   = app->GetFrameDeltaTime(currentTime - cachedTime);
             cachedTime        = currentTime;
-            app->Tick(deltaTime);
+            Profiler::GetProfiler().BeginFrame();
+            {
+                ST_PROFILE_SCOPE("Tick");
+                app->Tick(deltaTime);
+            }
+            {
+                ST_PROFILE_SCOPE("FixedTick");
+                app->RunFixedSteps(deltaTime);
+            }
             app->Render(deltaTime);
+            Profiler::GetProfiler().EndFrame();
+
+            float frameTime = app->GetAPPCurrentTime() - currentTime;
+            if(app->GetTargetFrameTime() > frameTime){
+                std::this_thread::sleep_for(std::chrono::duration<float>(app->GetTargetFrameTime() - frameTime));
+            }
         }
     }
     app->Destroy();
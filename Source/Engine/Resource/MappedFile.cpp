@@ -0,0 +1,87 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+bool ST::MappedFile::Open(const ST_STRING& fullPath) {
+	Close();
+	HANDLE file = CreateFileA(fullPath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+		CloseHandle(file);
+		return false;
+	}
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping) {
+		CloseHandle(file);
+		return false;
+	}
+	void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!data) {
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	_fileHandle    = file;
+	_mappingHandle = mapping;
+	_data          = static_cast<const unsigned char*>(data);
+	_size          = static_cast<size_t>(size.QuadPart);
+	return true;
+}
+
+void ST::MappedFile::Close() {
+	if (_data)
+		UnmapViewOfFile(_data);
+	if (_mappingHandle)
+		CloseHandle(_mappingHandle);
+	if (_fileHandle)
+		CloseHandle(_fileHandle);
+	_data          = nullptr;
+	_size          = 0;
+	_mappingHandle = nullptr;
+	_fileHandle    = nullptr;
+}
+#else
+bool ST::MappedFile::Open(const ST_STRING& fullPath) {
+	Close();
+	int file = open(fullPath.c_str(), O_RDONLY);
+	if (file < 0)
+		return false;
+
+	struct stat fileStat;
+	if (fstat(file, &fileStat) != 0 || fileStat.st_size == 0) {
+		close(file);
+		return false;
+	}
+	void* data = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	/* the mapping keeps its own reference to the file */
+	close(file);
+	if (data == MAP_FAILED)
+		return false;
+
+	_data = static_cast<const unsigned char*>(data);
+	_size = static_cast<size_t>(fileStat.st_size);
+	return true;
+}
+
+void ST::MappedFile::Close() {
+	if (_data)
+		munmap(const_cast<unsigned char*>(_data), _size);
+	_data = nullptr;
+	_size = 0;
+}
+#endif
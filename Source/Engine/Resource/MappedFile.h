@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Core.h"
+
+namespace ST {
+/* Read-only memory mapping of a whole file, unmapped on destruction */
+class MappedFile {
+public:
+	MappedFile() = default;
+
+	MappedFile(const MappedFile&) = delete;
+
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	~MappedFile() {
+		Close();
+	}
+
+	bool Open(const ST_STRING& fullPath);
+
+	void Close();
+
+	inline bool IsOpen() const {
+		return _data != nullptr;
+	}
+
+	inline const unsigned char* GetData() const {
+		return _data;
+	}
+
+	inline size_t GetSize() const {
+		return _size;
+	}
+
+private:
+	const unsigned char* _data = nullptr;
+
+	size_t _size = 0;
+
+#ifdef _WIN32
+	void* _fileHandle = nullptr;
+
+	void* _mappingHandle = nullptr;
+#endif
+};
+}
@@ -1,6 +1,10 @@
 ﻿#include "ResourceManager.h"
+
+#include <algorithm>
+
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
+#include "PathManager.h"
 #include "Render/CubeMap.h"
 #include "Render/Model.h"
 #include "Render/Shader.h"
@@ -9,6 +13,9 @@
 namespace ST {
 void ResourceManager::Init() {
 	stbi_set_flip_vertically_on_load(true);
+	uint32_t workerCount = std::thread::hardware_concurrency();
+	workerCount = workerCount > 2 ? std::min(workerCount - 1, 4u) : 1;
+	_textureLoader = ST_SCOPE<TextureLoader>(new TextureLoader(workerCount));
 }
 
 unsigned char* ResourceManager::LoadImageToCharPtr(std::string imagePath, int& width, int& height, int& channel) {
@@ -39,55 +46,188 @@ bool ResourceManager::LoadFileToStr(std::string filePath, std::string& outStr) {
 }
 
 ST_REF<Texture2D> ResourceManager::LoadTexture(const ST_STRING& path) {
-	auto it = _textures.find(path);
-	if (it != _textures.end()) {
-		return it->second;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		auto handle = _textures.Find(path);
+		if (handle.IsValid()) {
+			return _textures.GetRef(handle);
+		}
 	}
+	/* decoded and uploaded without the lock, the other thread may have added the path meanwhile */
 	auto texture = ST_MAKE_REF<Texture2D>(path);
-	_textures.emplace(path, texture);
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto handle = _textures.Find(path);
+	if (handle.IsValid()) {
+		return _textures.GetRef(handle);
+	}
+	_textures.Add(path, texture);
 	return texture;
 }
 
+ST_REF<Texture2D> ResourceManager::LoadTextureAsync(const ST_STRING& path) {
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _textures.GetRef(LoadTextureHandleLocked(path));
+}
+
+TextureHandle ResourceManager::LoadTextureHandle(const ST_STRING& path) {
+	std::lock_guard<std::mutex> lock(_mutex);
+	return LoadTextureHandleLocked(path);
+}
+
+TextureHandle ResourceManager::LoadTextureHandleLocked(const ST_STRING& path) {
+	auto handle = _textures.Find(path);
+	if (handle.IsValid()) {
+		return handle;
+	}
+	auto texture = ST_MAKE_REF<Texture2D>();
+	_textureLoader->Enqueue(PathManager::GetFullPath(path), texture);
+	return _textures.Add(path, texture);
+}
+
+void ResourceManager::UpdateTextureUploads() {
+	_textureLoader->Update(TEXTURE_UPLOAD_BYTES_PER_FRAME);
+	ST_VECTOR<ST_REF<void>> releases;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		EvictTextures();
+		releases.swap(_pendingReleases);
+	}
+	Texture2D::AdvanceFrame();
+}
+
+void ResourceManager::ShutdownTextureLoader() {
+	_textureLoader->Shutdown();
+}
+
+void ResourceManager::EvictTextures() {
+	struct EvictCandidate {
+		TextureHandle _handle;
+
+		uint64_t _lastBoundFrame;
+
+		size_t _bytes;
+	};
+
+	_textureBytes = 0;
+	ST_VECTOR<EvictCandidate> candidates;
+	uint64_t currentFrame = Texture2D::GetCurrentFrame();
+	_textures.ForEach([&](TextureHandle handle, const ST_REF<Texture2D>& texture) {
+		_textureBytes += texture->GetGpuBytes();
+		/* textures someone else still owns would not be freed, and last frame's textures are about to be used */
+		if (texture.use_count() == 1 && texture->GetLastBoundFrame() + 1 < currentFrame) {
+			candidates.push_back(EvictCandidate{handle, texture->GetLastBoundFrame(), texture->GetGpuBytes()});
+		}
+	});
+	if (_textureBytes <= _textureBudget)
+		return;
+
+	std::sort(candidates.begin(), candidates.end(), [](const EvictCandidate& lhs, const EvictCandidate& rhs) {
+		return lhs._lastBoundFrame < rhs._lastBoundFrame;
+	});
+	for (auto& candidate : candidates) {
+		if (_textureBytes <= _textureBudget)
+			break;
+		_textures.Remove(candidate._handle);
+		_textureBytes -= candidate._bytes;
+	}
+}
+
 ST_REF<Model> ResourceManager::LoadModel(const ST_STRING& path) {
-	auto it = _models.find(path);
-	if (it != _models.end()) {
-		return it->second;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		auto handle = _models.Find(path);
+		if (handle.IsValid()) {
+			return _models.GetRef(handle);
+		}
 	}
 	auto model = ST_MAKE_REF<Model>(path);
-	_models.emplace(path,model);
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto handle = _models.Find(path);
+	if (handle.IsValid()) {
+		return _models.GetRef(handle);
+	}
+	_models.Add(path, model);
 	return model;
 }
 
 ST_REF<Shader> ResourceManager::LoadShader(const ST_STRING& vertPath, const ST_STRING& fragPath) {
-	auto it = _shaders.find(vertPath);
-	if (it != _shaders.end()) {
-		return it->second;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		auto handle = _shaders.Find(vertPath);
+		if (handle.IsValid()) {
+			return _shaders.GetRef(handle);
+		}
 	}
 	auto shader = ST_MAKE_REF<Shader>(vertPath,fragPath);
-	_shaders.emplace(vertPath,shader);
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto handle = _shaders.Find(vertPath);
+	if (handle.IsValid()) {
+		return _shaders.GetRef(handle);
+	}
+	_shaders.Add(vertPath, shader);
+	if (_shaderReloader)
+		_shaderReloader->Watch(shader);
 	return shader;
 }
 
+void ResourceManager::EnableShaderHotReload(GLFWwindow* window) {
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (_shaderReloader)
+		return;
+	_shaderReloader = ST_SCOPE<ShaderReloader>(new ShaderReloader(window));
+	_shaders.ForEach([this](ResourceHandle<Shader>, const ST_REF<Shader>& shader) {
+		_shaderReloader->Watch(shader);
+	});
+}
+
+void ResourceManager::DisableShaderHotReload() {
+	std::lock_guard<std::mutex> lock(_mutex);
+	_shaderReloader.reset();
+}
+
+void ResourceManager::UpdateShaderReloads() {
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (_shaderReloader)
+		_shaderReloader->Update();
+}
+
 
 void ResourceManager::UnloadTexture(const ST_STRING& path) {
-	_textures.erase(path);
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto handle = _textures.Find(path);
+	_pendingReleases.push_back(_textures.GetRef(handle));
+	_textures.Remove(handle);
 }
 
 void ResourceManager::UnloadModel(const ST_STRING& path) {
-	_models.erase(path);
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto handle = _models.Find(path);
+	_pendingReleases.push_back(_models.GetRef(handle));
+	_models.Remove(handle);
 }
 
 void ResourceManager::UnloadShader(const ST_STRING& vertPath, const ST_STRING& fragPath) {
-	_shaders.erase(vertPath);
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto handle = _shaders.Find(vertPath);
+	_pendingReleases.push_back(_shaders.GetRef(handle));
+	_shaders.Remove(handle);
 }
 
 ST_REF<CubeMap> ResourceManager::LoadCubeMap(const ST_VECTOR<ST_STRING>& paths) {
-	auto it = _cubeMaps.find(paths[0]);
-	if (it != _cubeMaps.end()) {
-		return it->second;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		auto handle = _cubeMaps.Find(paths[0]);
+		if (handle.IsValid()) {
+			return _cubeMaps.GetRef(handle);
+		}
 	}
 	auto cubeMap = ST_MAKE_REF<CubeMap>(paths);
-	_cubeMaps.emplace(paths[0],cubeMap);
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto handle = _cubeMaps.Find(paths[0]);
+	if (handle.IsValid()) {
+		return _cubeMaps.GetRef(handle);
+	}
+	_cubeMaps.Add(paths[0], cubeMap);
 	return cubeMap;
 }
 }
@@ -1,5 +1,11 @@
 ﻿#pragma once
+#include <mutex>
+
 #include "Core.h"
+#include "ResourceRegistry.h"
+#include "ShaderReloader.h"
+#include "TextureLoader.h"
+#include "Render/Texture2D.h"
 
 namespace ST {
 class CubeMap;
@@ -10,6 +16,12 @@ class Texture2D;
 
 class Model;
 
+/*
+ * The game and render threads both load and look up resources, every entry point that touches a registry holds
+ * _mutex. Loads that create GL objects (LoadTexture, LoadModel, LoadShader, LoadCubeMap) also need the GL context,
+ * so they stay on whichever thread has it current: the main thread before the render thread starts, then the
+ * render thread.
+ */
 class ResourceManager {
 public:
 	unsigned char* LoadImageToCharPtr(ST_STRING imagePath, int& width, int& height, int& channel);
@@ -26,12 +38,66 @@ public:
 
 	ST_REF<Texture2D> LoadTexture(const ST_STRING& path);
 
+	/* Returns at once with a placeholder, the image is decoded on a worker and swapped in by UpdateTextureUploads */
+	ST_REF<Texture2D> LoadTextureAsync(const ST_STRING& path);
+
+	/* On the thread with the GL context, before it goes away: stops decoding and frees the loader's GL objects */
+	void ShutdownTextureLoader();
+
+	/* Render thread, once per frame: uploads finished decodes, evicts textures over budget and releases unloaded
+	   resources */
+	void UpdateTextureUploads();
+
+	/* Least recently bound textures are evicted past this, they reload on their next use */
+	void SetTextureBudget(size_t bytes) {
+		std::lock_guard<std::mutex> lock(_mutex);
+		_textureBudget = bytes;
+	}
+
+	size_t GetTextureBudget() const {
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _textureBudget;
+	}
+
+	/* Estimated bytes of every registered texture as of the last UpdateTextureUploads */
+	size_t GetTextureBytes() const {
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _textureBytes;
+	}
+
+	/* Same as LoadTextureAsync but hands out a handle, hot paths keep it and resolve with GetTexture */
+	TextureHandle LoadTextureHandle(const ST_STRING& path);
+
+	/* Invalid handle if the texture is not loaded. Creates nothing, so threads without the GL context may call it */
+	inline TextureHandle FindTexture(const ST_STRING& path) const {
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _textures.Find(path);
+	}
+
+	/* O(1), nullptr once the texture has been unloaded. Only dereference it on the render thread, the pointer is
+	   valid until the next UpdateTextureUploads */
+	inline Texture2D* GetTexture(TextureHandle handle) const {
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _textures.Get(handle);
+	}
+
 	ST_REF<Model> LoadModel(const ST_STRING& path);
 
 	ST_REF<Shader> LoadShader(const ST_STRING& vertPath, const ST_STRING& fragPath);
 
+	/* Recompiles shaders from LoadShader when their sources are edited, window's context is shared with the
+	   compile thread. Disable before the window is destroyed */
+	void EnableShaderHotReload(GLFWwindow* window);
+
+	void DisableShaderHotReload();
+
+	/* Render thread, once per frame: swaps in shaders recompiled since the last frame */
+	void UpdateShaderReloads();
+
 	ST_REF<CubeMap> LoadCubeMap(const ST_VECTOR<ST_STRING>& paths);
 
+	/* Unloads are safe on any thread, the registry's reference is dropped by the next UpdateTextureUploads on the
+	   render thread so GL objects are deleted where the context is current */
 	void UnloadTexture(const ST_STRING& path);
 
 	void UnloadModel(const ST_STRING& path);
@@ -39,13 +105,35 @@ public:
 	void UnloadShader(const ST_STRING& vertPath, const ST_STRING& fragPath);
 
 private:
-	ST_MAP<ST_STRING, ST_REF<Texture2D>> _textures;
+	mutable std::mutex _mutex;
+
+	ResourceRegistry<Texture2D> _textures;
+
+	ResourceRegistry<Model> _models;
+
+	/* keyed by vertex shader path */
+	ResourceRegistry<Shader> _shaders;
+
+	/* keyed by the first face path */
+	ResourceRegistry<CubeMap> _cubeMaps;
+
+	ST_VECTOR<ST_REF<void>> _pendingReleases;
+
+	ST_SCOPE<TextureLoader> _textureLoader;
+
+	ST_SCOPE<ShaderReloader> _shaderReloader;
+
+	size_t _textureBudget = static_cast<size_t>(512) << 20;
+
+	size_t _textureBytes = 0;
 
-	ST_MAP<ST_STRING, ST_REF<Model>> _models;
+	/* _mutex held */
+	TextureHandle LoadTextureHandleLocked(const ST_STRING& path);
 
-	ST_MAP<ST_STRING, ST_REF<Shader>> _shaders;
+	/* _mutex held */
+	void EvictTextures();
 
-	ST_MAP<ST_STRING,ST_REF<CubeMap>> _cubeMaps;
+	static constexpr size_t TEXTURE_UPLOAD_BYTES_PER_FRAME = 16 << 20;
 
 	void Init();
 
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "Core.h"
+
+namespace ST {
+/* FNV-1a 64, used to intern resource paths */
+inline uint64_t HashResourcePath(const ST_STRING& path) {
+	uint64_t hash = 14695981039346656037ull;
+	for (char c : path) {
+		hash = (hash ^ static_cast<uint8_t>(c)) * 1099511628211ull;
+	}
+	return hash;
+}
+
+/*
+ * Slot index in the low 20 bits, slot generation in the high 12. Generations start at 1 so a zero
+ * handle is never live, and removing a resource bumps its slot's generation so old handles go stale.
+ */
+template <typename T>
+struct ResourceHandle {
+	static constexpr uint32_t INDEX_BITS      = 20;
+	static constexpr uint32_t INDEX_MASK      = (1u << INDEX_BITS) - 1;
+	static constexpr uint32_t GENERATION_MASK = (1u << (32 - INDEX_BITS)) - 1;
+
+	ResourceHandle() = default;
+
+	ResourceHandle(uint32_t index, uint32_t generation): _value(generation << INDEX_BITS | index) {}
+
+	inline bool IsValid() const {
+		return _value != 0;
+	}
+
+	inline uint32_t GetIndex() const {
+		return _value & INDEX_MASK;
+	}
+
+	inline uint32_t GetGeneration() const {
+		return _value >> INDEX_BITS;
+	}
+
+	inline bool operator==(const ResourceHandle& other) const {
+		return _value == other._value;
+	}
+
+	inline bool operator!=(const ResourceHandle& other) const {
+		return _value != other._value;
+	}
+
+	uint32_t _value = 0;
+};
+
+/* Dense slot array of resources addressed by generational handles, with path interning for lookup by name */
+template <typename T>
+class ResourceRegistry {
+public:
+	using Handle = ResourceHandle<T>;
+
+	/* Invalid handle if the path was never added or has been removed */
+	Handle Find(const ST_STRING& path) const {
+		auto it = _pathToSlot.find(HashResourcePath(path));
+		if (it == _pathToSlot.end())
+			return Handle();
+		const Slot& slot = _slots[it->second];
+		return slot._path == path ? Handle(it->second, slot._generation) : Handle();
+	}
+
+	Handle Add(const ST_STRING& path, ST_REF<T> resource) {
+		uint32_t index;
+		if (!_freeSlots.empty()) {
+			index = _freeSlots.back();
+			_freeSlots.pop_back();
+		}
+		else {
+			ST_ASSERT(_slots.size() <= Handle::INDEX_MASK, "Resource registry is full");
+			index = static_cast<uint32_t>(_slots.size());
+			_slots.emplace_back();
+		}
+		Slot& slot = _slots[index];
+		slot._resource = std::move(resource);
+		slot._path     = path;
+		uint64_t hash = HashResourcePath(path);
+		ST_ASSERT(_pathToSlot.find(hash) == _pathToSlot.end(), "Resource path hash collision: %s\n", path.c_str());
+		_pathToSlot[hash] = index;
+		return Handle(index, slot._generation);
+	}
+
+	/* O(1), nullptr for a stale or invalid handle */
+	inline T* Get(Handle handle) const {
+		uint32_t index = handle.GetIndex();
+		if (index >= _slots.size() || _slots[index]._generation != handle.GetGeneration())
+			return nullptr;
+		return _slots[index]._resource.get();
+	}
+
+	/* Shared ownership for callers that outlive the registry entry */
+	ST_REF<T> GetRef(Handle handle) const {
+		uint32_t index = handle.GetIndex();
+		if (index >= _slots.size() || _slots[index]._generation != handle.GetGeneration())
+			return nullptr;
+		return _slots[index]._resource;
+	}
+
+	/* func(Handle, const ST_REF<T>&) for every live resource */
+	template <typename Func>
+	void ForEach(Func&& func) const {
+		for (uint32_t index = 0; index < _slots.size(); ++index) {
+			if (_slots[index]._resource)
+				func(Handle(index, _slots[index]._generation), _slots[index]._resource);
+		}
+	}
+
+	void Remove(Handle handle) {
+		if (!Get(handle))
+			return;
+		uint32_t index = handle.GetIndex();
+		Slot& slot = _slots[index];
+		_pathToSlot.erase(HashResourcePath(slot._path));
+		slot._resource.reset();
+		slot._path.clear();
+		/* skip 0 on wrap around so a zero handle stays invalid */
+		slot._generation = (slot._generation & Handle::GENERATION_MASK) == Handle::GENERATION_MASK
+			? 1
+			: slot._generation + 1;
+		_freeSlots.push_back(index);
+	}
+
+private:
+	struct Slot {
+		ST_REF<T> _resource;
+
+		ST_STRING _path;
+
+		uint32_t _generation = 1;
+	};
+
+	ST_VECTOR<Slot> _slots;
+
+	ST_VECTOR<uint32_t> _freeSlots;
+
+	ST_UNORDERED_MAP<uint64_t, uint32_t> _pathToSlot;
+};
+}
@@ -0,0 +1,175 @@
+#include "ShaderReloader.h"
+
+#include <algorithm>
+#include <chrono>
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#else
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+
+#include "ResourceManager.h"
+#include "Render/Shader.h"
+#include "Render/ShaderCache.h"
+
+namespace ST {
+namespace {
+/* editors often write a file in several steps, wait for them to settle before compiling */
+constexpr auto SETTLE_TIME = std::chrono::milliseconds(50);
+
+constexpr int POLL_INTERVAL_MS = 250;
+
+#ifndef __linux__
+int64_t GetFileTime(const ST_STRING& fullPath) {
+	struct stat fileStat;
+	return stat(fullPath.c_str(), &fileStat) == 0 ? static_cast<int64_t>(fileStat.st_mtime) : 0;
+}
+#endif
+}
+
+ShaderReloader::ShaderReloader(GLFWwindow* sharedWindow) {
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	_context = glfwCreateWindow(1, 1, "ShaderReloader", nullptr, sharedWindow);
+	glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+	if (!_context) {
+		ST_LOG("Shader hot reload disabled, could not create a shared context\n");
+		return;
+	}
+#ifdef __linux__
+	_notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+	_worker = std::thread(&ShaderReloader::WorkerLoop, this);
+}
+
+ShaderReloader::~ShaderReloader() {
+	_stop = true;
+	if (_worker.joinable())
+		_worker.join();
+#ifdef __linux__
+	if (_notifyFd >= 0)
+		close(_notifyFd);
+#endif
+	for (auto& compiled : _compiled) {
+		glDeleteProgram(compiled._program);
+	}
+	if (_context)
+		glfwDestroyWindow(_context);
+}
+
+void ShaderReloader::Watch(const ST_REF<Shader>& shader) {
+	if (!_context)
+		return;
+	WatchedShader watched{shader, shader->GetVertFullPath(), shader->GetFragFullPath()};
+	std::lock_guard<std::mutex> lock(_mutex);
+#ifdef __linux__
+	for (const ST_STRING* path : {&watched._vertFullPath, &watched._fragFullPath}) {
+		ST_STRING dir = path->substr(0, path->find_last_of('/') + 1);
+		/* a second watch on the same directory returns the existing descriptor */
+		int descriptor = inotify_add_watch(_notifyFd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+		if (descriptor >= 0)
+			_watchedDirs[descriptor] = dir;
+	}
+#else
+	_fileTimes[watched._vertFullPath] = GetFileTime(watched._vertFullPath);
+	_fileTimes[watched._fragFullPath] = GetFileTime(watched._fragFullPath);
+#endif
+	_watched.push_back(std::move(watched));
+}
+
+void ShaderReloader::Update() {
+	std::deque<CompiledProgram> compiled;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		compiled.swap(_compiled);
+	}
+	for (auto& program : compiled) {
+		auto shader = program._shader.lock();
+		if (shader)
+			shader->ReplaceProgram(program._program, program._cacheKey);
+		else
+			glDeleteProgram(program._program);
+	}
+}
+
+void ShaderReloader::WorkerLoop() {
+	glfwMakeContextCurrent(_context);
+	ST_VECTOR<ST_STRING> changedPaths;
+	while (!_stop) {
+		changedPaths.clear();
+		PollChanges(changedPaths);
+		if (changedPaths.empty())
+			continue;
+		std::this_thread::sleep_for(SETTLE_TIME);
+		PollChanges(changedPaths);
+
+		ST_VECTOR<WatchedShader> affected;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_watched.erase(std::remove_if(_watched.begin(), _watched.end(), [](const WatchedShader& watched) {
+				return watched._shader.expired();
+			}), _watched.end());
+			for (auto& watched : _watched) {
+				if (std::find(changedPaths.begin(), changedPaths.end(), watched._vertFullPath) != changedPaths.end() ||
+					std::find(changedPaths.begin(), changedPaths.end(), watched._fragFullPath) != changedPaths.end())
+					affected.push_back(watched);
+			}
+		}
+		for (auto& watched : affected) {
+			Recompile(watched);
+		}
+	}
+	glfwMakeContextCurrent(nullptr);
+}
+
+void ShaderReloader::PollChanges(ST_VECTOR<ST_STRING>& changedPaths) {
+#ifdef __linux__
+	pollfd descriptor{_notifyFd, POLLIN, 0};
+	if (_notifyFd < 0 || poll(&descriptor, 1, POLL_INTERVAL_MS) <= 0)
+		return;
+
+	alignas(inotify_event) char buffer[4096];
+	ssize_t length;
+	while ((length = read(_notifyFd, buffer, sizeof(buffer))) > 0) {
+		std::lock_guard<std::mutex> lock(_mutex);
+		for (char* cursor = buffer; cursor < buffer + length;) {
+			const inotify_event* event = reinterpret_cast<const inotify_event*>(cursor);
+			auto dir = _watchedDirs.find(event->wd);
+			if (event->len > 0 && dir != _watchedDirs.end())
+				changedPaths.push_back(dir->second + event->name);
+			cursor += sizeof(inotify_event) + event->len;
+		}
+	}
+#else
+	std::this_thread::sleep_for(std::chrono::milliseconds(POLL_INTERVAL_MS));
+	std::lock_guard<std::mutex> lock(_mutex);
+	for (auto& file : _fileTimes) {
+		int64_t time = GetFileTime(file.first);
+		if (time != file.second) {
+			file.second = time;
+			changedPaths.push_back(file.first);
+		}
+	}
+#endif
+}
+
+void ShaderReloader::Recompile(const WatchedShader& watched) {
+	ST_STRING vertSource, fragSource;
+	auto& resourceManager = ResourceManager::GetResourceManager();
+	if (!resourceManager.LoadFileToStr(watched._vertFullPath, vertSource) ||
+		!resourceManager.LoadFileToStr(watched._fragFullPath, fragSource))
+		return;
+
+	unsigned int program = Shader::CompileProgram(vertSource, fragSource);
+	if (!program) {
+		ST_LOG("Shader reload failed, keeping the previous program: %s\n", watched._vertFullPath.c_str());
+		return;
+	}
+	/* the main context may only use the program once the link has finished here */
+	glFinish();
+	std::lock_guard<std::mutex> lock(_mutex);
+	_compiled.push_back(CompiledProgram{watched._shader, program, ShaderCache::MakeKey(vertSource, fragSource)});
+}
+}
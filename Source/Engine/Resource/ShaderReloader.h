@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "Core.h"
+
+struct GLFWwindow;
+
+namespace ST {
+class Shader;
+
+/*
+ * Watches the sources of loaded shaders and recompiles edited ones on a worker thread that owns a hidden
+ * context shared with the main window. Linked programs are swapped in by Update at a frame boundary, a
+ * failed compile is logged and the shader keeps its current program.
+ */
+class ShaderReloader {
+public:
+	/* Main thread, sharedWindow's context must stay alive until the reloader is destroyed */
+	explicit ShaderReloader(GLFWwindow* sharedWindow);
+
+	~ShaderReloader();
+
+	ShaderReloader(const ShaderReloader&) = delete;
+
+	ShaderReloader& operator=(const ShaderReloader&) = delete;
+
+	void Watch(const ST_REF<Shader>& shader);
+
+	/* Render thread, once per frame */
+	void Update();
+
+private:
+	struct WatchedShader {
+		ST_WEAK_REF<Shader> _shader;
+
+		ST_STRING _vertFullPath;
+
+		ST_STRING _fragFullPath;
+	};
+
+	struct CompiledProgram {
+		ST_WEAK_REF<Shader> _shader;
+
+		unsigned int _program;
+
+		uint64_t _cacheKey;
+	};
+
+	void WorkerLoop();
+
+	/* Blocks for a short while and appends the full paths of files that changed since the last call */
+	void PollChanges(ST_VECTOR<ST_STRING>& changedPaths);
+
+	void Recompile(const WatchedShader& watched);
+
+	GLFWwindow* _context = nullptr;
+
+	std::thread _worker;
+
+	std::atomic<bool> _stop{false};
+
+	std::mutex _mutex;
+
+	ST_VECTOR<WatchedShader> _watched;
+
+	std::deque<CompiledProgram> _compiled;
+
+#ifdef __linux__
+	int _notifyFd = -1;
+
+	/* watch descriptor to directory, with a trailing slash */
+	ST_UNORDERED_MAP<int, ST_STRING> _watchedDirs;
+#else
+	/* polled modification times when no change notification API is wired up */
+	ST_UNORDERED_MAP<ST_STRING, int64_t> _fileTimes;
+#endif
+};
+}
@@ -0,0 +1,129 @@
+#include "TextureLoader.h"
+
+#include <cstring>
+
+#include "Profiler.h"
+#include "ResourceManager.h"
+#include "stb_image.h"
+#include "Render/Texture2D.h"
+
+ST::TextureLoader::TextureLoader(uint32_t workerCount) {
+	for (uint32_t i = 0; i < workerCount; ++i) {
+		_workers.emplace_back(&TextureLoader::WorkerLoop, this);
+	}
+}
+
+ST::TextureLoader::~TextureLoader() {
+	StopWorkers();
+}
+
+void ST::TextureLoader::Shutdown() {
+	StopWorkers();
+	if (_pixelBuffer) {
+		glDeleteBuffers(1, &_pixelBuffer);
+		_pixelBuffer = 0;
+	}
+}
+
+void ST::TextureLoader::StopWorkers() {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_condition.notify_all();
+	for (auto& worker : _workers) {
+		worker.join();
+	}
+	_workers.clear();
+	/* the ResourceManager may already be destroyed when this runs from the destructor */
+	for (auto& image : _decoded) {
+		stbi_image_free(image._pixels);
+	}
+	_decoded.clear();
+}
+
+void ST::TextureLoader::Enqueue(const ST_STRING& fullPath, ST_REF<Texture2D> texture) {
+	++_pendingCount;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_requests.push_back(DecodeRequest{fullPath, texture});
+	}
+	_condition.notify_one();
+}
+
+void ST::TextureLoader::WorkerLoop() {
+	while (true) {
+		DecodeRequest request;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_condition.wait(lock, [this] { return _stop || !_requests.empty(); });
+			if (_stop)
+				return;
+			request = std::move(_requests.front());
+			_requests.pop_front();
+		}
+
+		/* nobody holds the texture any more, skip the decode */
+		if (request._texture.expired()) {
+			--_pendingCount;
+			continue;
+		}
+
+		DecodedImage image{request._texture, nullptr, 0, 0, 0};
+		image._pixels = ResourceManager::GetResourceManager().LoadImageToCharPtr(request._fullPath,
+			image._width, image._height, image._channel);
+		if (!image._pixels) {
+			/* keeps the placeholder, LoadImageToCharPtr already logged the failure */
+			--_pendingCount;
+			continue;
+		}
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		_decoded.push_back(image);
+	}
+}
+
+void ST::TextureLoader::Update(size_t maxUploadBytes) {
+	size_t uploadedBytes = 0;
+	while (uploadedBytes < maxUploadBytes) {
+		DecodedImage image;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			if (_decoded.empty())
+				break;
+			image = _decoded.front();
+			_decoded.pop_front();
+		}
+		Upload(image);
+		uploadedBytes += static_cast<size_t>(image._width) * image._height * image._channel;
+		ResourceManager::GetResourceManager().UnloadImage(image._pixels);
+		--_pendingCount;
+	}
+}
+
+void ST::TextureLoader::Upload(const DecodedImage& image) {
+	auto texture = image._texture.lock();
+	if (!texture)
+		return;
+
+	if (!_pixelBuffer)
+		glGenBuffers(1, &_pixelBuffer);
+
+	/* orphan the previous storage so the copy never waits on an upload still in flight */
+	GLsizeiptr size = static_cast<GLsizeiptr>(image._width) * image._height * image._channel;
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pixelBuffer);
+	glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+	void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size,
+		GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+	if (mapped) {
+		memcpy(mapped, image._pixels, size);
+		ST_PROFILE_UPLOAD(size);
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+		texture->UploadImage(image._width, image._height, image._channel, nullptr);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	}
+	else {
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		texture->UploadImage(image._width, image._height, image._channel, image._pixels);
+	}
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "Core.h"
+
+namespace ST {
+class Texture2D;
+
+/*
+ * Decodes images on worker threads. Finished images are uploaded on the render thread by Update,
+ * through a pixel unpack buffer, into the placeholder texture handed out when the load was queued.
+ */
+class TextureLoader {
+public:
+	explicit TextureLoader(uint32_t workerCount);
+
+	/* Only stops the workers, the pixel buffer needs Shutdown while the context is still current */
+	~TextureLoader();
+
+	TextureLoader(const TextureLoader&) = delete;
+
+	TextureLoader& operator=(const TextureLoader&) = delete;
+
+	void Enqueue(const ST_STRING& fullPath, ST_REF<Texture2D> texture);
+
+	/* Render thread only, uploads at least one finished image and then stops once maxUploadBytes is spent */
+	void Update(size_t maxUploadBytes);
+
+	/* Stops the workers and deletes the pixel buffer, on the thread that has the GL context. Nothing is decoded
+	   or uploaded afterwards */
+	void Shutdown();
+
+	inline uint32_t GetPendingCount() const {
+		return _pendingCount.load();
+	}
+
+private:
+	struct DecodeRequest {
+		ST_STRING _fullPath;
+
+		ST_WEAK_REF<Texture2D> _texture;
+	};
+
+	struct DecodedImage {
+		ST_WEAK_REF<Texture2D> _texture;
+
+		unsigned char* _pixels;
+
+		int _width;
+
+		int _height;
+
+		int _channel;
+	};
+
+	void WorkerLoop();
+
+	/* Joins the workers and frees images never uploaded, touches neither GL nor the ResourceManager */
+	void StopWorkers();
+
+	void Upload(const DecodedImage& image);
+
+	ST_VECTOR<std::thread> _workers;
+
+	std::deque<DecodeRequest> _requests;
+
+	std::deque<DecodedImage> _decoded;
+
+	std::mutex _mutex;
+
+	std::condition_variable _condition;
+
+	bool _stop = false;
+
+	std::atomic<uint32_t> _pendingCount{0};
+
+	unsigned int _pixelBuffer = 0;
+};
+}
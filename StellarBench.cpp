@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+#include "Application.h"
+#include "Profiler.h"
+
+using namespace ST;
+
+/*
+ * Renders the default scene headless for a fixed number of frames with a fixed delta time and writes
+ * frame time percentiles, draw calls and uploaded bytes as JSON.
+ * STELLAR_BENCH_FRAMES and STELLAR_BENCH_OUTPUT override the frame count and the report path.
+ */
+class StellarBench : public ST::Application {
+public:
+	static constexpr float FIXED_DELTA_TIME = 1.f / 60.f;
+
+	/* async texture uploads and shader cache writes settle during these */
+	static constexpr uint32_t WARMUP_FRAMES = 60;
+
+	StellarBench(): ST::Application(true) {
+		SetFixedTimeStep(FIXED_DELTA_TIME);
+		const char* frames = std::getenv("STELLAR_BENCH_FRAMES");
+		const char* output = std::getenv("STELLAR_BENCH_OUTPUT");
+		_benchFrames = frames ? static_cast<uint32_t>(std::max(1, std::atoi(frames))) : 600;
+		_outputPath  = output ? output : "StellarBench.json";
+	}
+
+	/* every frame runs exactly one fixed step, whatever the frame took */
+	virtual float GetFrameDeltaTime(float) override {
+		return FIXED_DELTA_TIME;
+	}
+
+	virtual void Tick(float deltaTime) override {
+		/* the record of the previous frame is complete by the time the next one ticks */
+		auto& history = Profiler::GetProfiler().GetHistory();
+		if (_frame > WARMUP_FRAMES && !history.empty())
+			Collect(history.back());
+		Application::Tick(deltaTime);
+	}
+
+	virtual void Render(float deltaTime) override {
+		Application::Render(deltaTime);
+		if (++_frame == WARMUP_FRAMES + _benchFrames)
+			_shouldClose = true;
+	}
+
+	virtual void Destroy() override {
+		auto& history = Profiler::GetProfiler().GetHistory();
+		if (!history.empty())
+			Collect(history.back());
+		WriteReport();
+		Application::Destroy();
+	}
+
+private:
+	void Collect(const FrameRecord& frame) {
+		_frameTimesMs.push_back((frame._endNs - frame._beginNs) / 1e6);
+		_drawCalls.push_back(frame._drawCalls);
+		_uploadedBytes += frame._uploadedBytes;
+	}
+
+	static double Percentile(const ST_VECTOR<double>& sorted, double percentile) {
+		size_t index = static_cast<size_t>(percentile / 100.0 * (sorted.size() - 1) + 0.5);
+		return sorted[std::min(index, sorted.size() - 1)];
+	}
+
+	void WriteReport() const {
+		if (_frameTimesMs.empty()) {
+			ST_LOG("StellarBench: no frames recorded\n");
+			return;
+		}
+		ST_VECTOR<double> sorted = _frameTimesMs;
+		std::sort(sorted.begin(), sorted.end());
+		double totalMs = 0;
+		for (double frameTime : sorted) {
+			totalMs += frameTime;
+		}
+		uint64_t totalDrawCalls = 0;
+		for (uint32_t drawCalls : _drawCalls) {
+			totalDrawCalls += drawCalls;
+		}
+
+		/* GPU timings of the frames still held in the profiler history */
+		ST_MAP<ST_STRING, std::pair<double, uint32_t>> gpuPasses;
+		for (auto& frame : Profiler::GetProfiler().GetHistory()) {
+			if (frame._frameIndex < WARMUP_FRAMES)
+				continue;
+			for (auto& pass : frame._gpuPasses) {
+				auto& total = gpuPasses[pass._name];
+				total.first += pass._elapsedNs / 1e6;
+				++total.second;
+			}
+		}
+
+		std::ofstream stream(_outputPath, std::ios::trunc);
+		stream << "{\n"
+			<< "  \"frames\": " << sorted.size() << ",\n"
+			<< "  \"frameTimeMs\": {\"mean\": " << totalMs / sorted.size()
+			<< ", \"p50\": " << Percentile(sorted, 50) << ", \"p90\": " << Percentile(sorted, 90)
+			<< ", \"p99\": " << Percentile(sorted, 99) << ", \"max\": " << sorted.back() << "},\n"
+			<< "  \"drawCallsPerFrame\": " << static_cast<double>(totalDrawCalls) / _drawCalls.size() << ",\n"
+			<< "  \"uploadedBytes\": " << _uploadedBytes << ",\n"
+			<< "  \"gpuPassMeanMs\": {";
+		bool first = true;
+		for (auto& pass : gpuPasses) {
+			stream << (first ? "" : ", ") << "\"" << pass.first << "\": " << pass.second.first / pass.second.second;
+			first = false;
+		}
+		stream << "}\n}\n";
+		stream.close();
+		ST_LOG("StellarBench: %zu frames, p50 %.3f ms, p99 %.3f ms, report written to %s\n", sorted.size(),
+			Percentile(sorted, 50), Percentile(sorted, 99), _outputPath.c_str());
+	}
+
+	uint32_t _benchFrames;
+
+	ST_STRING _outputPath;
+
+	uint32_t _frame = 0;
+
+	ST_VECTOR<double> _frameTimesMs;
+
+	ST_VECTOR<uint32_t> _drawCalls;
+
+	uint64_t _uploadedBytes = 0;
+};
+
+ST::Application* CreateApplication() {
+	return new StellarBench();
+}